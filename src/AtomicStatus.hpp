@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Status shared by exactly two threads that take turns.
+        // Waiting spins for a short while before the thread is put to sleep (futex on Linux).
+        // Stores release everything written before them to the thread that observes the new status.
+        template <class Status>
+        class AtomicStatus
+        {
+            static_assert(sizeof(std::atomic<int>) == sizeof(int), "Futex requires a plain int.");
+
+        private:
+            std::atomic<int> _status;
+            std::atomic<int> _sleepers{0};
+#ifndef __linux__
+            std::mutex _mutex;
+            std::condition_variable _cv;
+#endif
+
+        public:
+            explicit AtomicStatus(Status status) : _status(static_cast<int>(status)) { }
+
+            AtomicStatus(AtomicStatus const&) = delete;
+            AtomicStatus& operator=(AtomicStatus const&) = delete;
+
+        public:
+            Status Load() const { return static_cast<Status>(_status.load(std::memory_order_acquire)); }
+
+            void Store(Status status)
+            {
+#ifdef __linux__
+                _status.store(static_cast<int>(status));
+                if (_sleepers.load() != 0)
+                    syscall(SYS_futex, Address(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _status.store(static_cast<int>(status));
+                }
+                _cv.notify_all();
+#endif
+            }
+
+            // Stores the new status only if the current one is the expected one. Returns whether it did.
+            bool CompareExchange(Status expected, Status status)
+            {
+                auto value = static_cast<int>(expected);
+#ifdef __linux__
+                if (!_status.compare_exchange_strong(value, static_cast<int>(status)))
+                    return false;
+
+                if (_sleepers.load() != 0)
+                    syscall(SYS_futex, Address(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    if (!_status.compare_exchange_strong(value, static_cast<int>(status)))
+                        return false;
+                }
+                _cv.notify_all();
+#endif
+                return true;
+            }
+
+            // Returns the first status different from the given one.
+            Status WaitWhile(Status status)
+            {
+                auto value = static_cast<int>(status);
+
+                for (int i = SpinCount(); i > 0; --i)
+                {
+                    if (_status.load(std::memory_order_acquire) != value)
+                        return Load();
+                    Pause();
+                }
+
+                ++_sleepers;
+#ifdef __linux__
+                while (_status.load() == value)
+                    syscall(SYS_futex, Address(), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#else
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    while (_status.load() == value)
+                        _cv.wait(lock);
+                }
+#endif
+                --_sleepers;
+
+                return Load();
+            }
+
+        // Internals
+        private:
+            int* Address() { return reinterpret_cast<int*>(&_status); }
+
+            static int SpinCount()
+            {
+                // Spinning only makes sense if the other thread can run in the meantime.
+                static int const spinCount = std::thread::hardware_concurrency() > 1 ? 4096 : 0;
+                return spinCount;
+            }
+
+            static void Pause()
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#elif defined(__aarch64__)
+                asm volatile("yield");
+#endif
+            }
+        };
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "ForEach.hpp"
+#include "Reduction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iterator>
+#include <stdexcept>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        // Neumaier's compensated sum, which keeps small addends next to large ones.
+        template <class F>
+        class CompensatedSum
+        {
+        private:
+            F _sum = 0;
+            F _compensation = 0;
+
+        public:
+            // False if adding value would overflow, which a smaller scale avoids.
+            bool Fits(F value) const { return std::isfinite(_sum + value) || !std::isfinite(value) || !std::isfinite(_sum); }
+
+            void Add(F value)
+            {
+                F sum = _sum + value;
+                if (std::abs(_sum) >= std::abs(value))
+                    _compensation += (_sum - sum) + value;
+                else
+                    _compensation += (value - sum) + _sum;
+
+                _sum = sum;
+            }
+
+            void Scale(F factor)
+            {
+                _sum *= factor;
+                _compensation *= factor;
+            }
+
+            F Result() const { return _sum + _compensation; }
+        };
+
+        // Mean in a single pass with a single division. Elements are multiplied by a power of two
+        // that is halved whenever the sum would overflow otherwise, which keeps every step exact.
+        // Blocks of arithmetic elements are summed in vectorizable partial sums first, which only fall back
+        // to element-wise summation if they overflow.
+        template <class Result>
+        class MeanAccumulator
+        {
+        private:
+            static constexpr size_t Lanes = 64 / sizeof(Result);
+
+        private:
+            CompensatedSum<Result> _sum;
+            Result _scale = 1;
+            size_t _count = 0;
+
+        public:
+            template <class T>
+            void Add(T const& value)
+            {
+                AddScaled(value * _scale);
+                ++_count;
+            }
+
+            template <class U>
+            void Add(U const* values, size_t count)
+            {
+                for (size_t offset = 0; offset < count; offset += BlockSize)
+                    AddBlock(values + offset, std::min(BlockSize, count - offset));
+            }
+
+            bool IsEmpty() const { return _count == 0; }
+            Result Mean() const { return _sum.Result() / static_cast<Result>(_count) / _scale; }
+
+        private:
+            void AddScaled(Result scaled)
+            {
+                while (!_sum.Fits(scaled))
+                {
+                    _sum.Scale(0.5);
+                    _scale *= 0.5;
+                    scaled *= 0.5;
+                }
+
+                _sum.Add(scaled);
+            }
+
+            template <class U>
+            void AddBlock(U const* values, size_t count)
+            {
+                Result partial[Lanes] = {};
+                size_t i = 0;
+                for (; i + Lanes <= count; i += Lanes)
+                {
+                    for (size_t j = 0; j < Lanes; ++j)
+                        partial[j] += values[i + j] * _scale;
+                }
+
+                for (size_t j = 0; i < count; ++i, ++j)
+                    partial[j] += values[i] * _scale;
+
+                Result sum = 0;
+                for (size_t j = 0; j < Lanes; ++j)
+                    sum += partial[j];
+
+                if (!std::isfinite(sum))
+                {
+                    for (i = 0; i < count; ++i)
+                        Add(values[i]);
+
+                    return;
+                }
+
+                AddScaled(sum);
+                _count += count;
+            }
+        };
+
+        template <class F>
+        class MeanAccumulator<std::complex<F>>
+        {
+        private:
+            CompensatedSum<F> _real;
+            CompensatedSum<F> _imag;
+            F _scale = 1;
+            size_t _count = 0;
+
+        public:
+            template <class T>
+            void Add(T const& value)
+            {
+                std::complex<F> scaled = value * _scale;
+                while (!_real.Fits(scaled.real()) || !_imag.Fits(scaled.imag()))
+                {
+                    _real.Scale(0.5);
+                    _imag.Scale(0.5);
+                    _scale *= 0.5;
+                    scaled *= 0.5;
+                }
+
+                _real.Add(scaled.real());
+                _imag.Add(scaled.imag());
+                ++_count;
+            }
+
+            bool IsEmpty() const { return _count == 0; }
+            std::complex<F> Mean() const { return std::complex<F>(_real.Result(), _imag.Result()) / static_cast<F>(_count) / _scale; }
+        };
+
+        template <class Result, class InputIterator>
+        auto InternalAverage(InputIterator first, InputIterator last, std::true_type)
+        {
+            return Reduce(first, last, MeanAccumulator<Result>());
+        }
+
+        template <class Result, class InputIterator>
+        auto InternalAverage(InputIterator first, InputIterator last, std::false_type)
+        {
+            MeanAccumulator<Result> mean;
+            ForEach(first, last, [&](auto const& value)
+            {
+                mean.Add(value);
+                return true;
+            });
+
+            return mean;
+        }
+    }
+
+    template <class InputIterator>
+    auto Average(InputIterator first, InputIterator last)
+    {
+        using Result = decltype(*first * 1.0);
+
+        auto mean = Detail::InternalAverage<Result>(first, last, Detail::IsBlockElement<decltype(*first)>());
+        if (mean.IsEmpty())
+            throw std::invalid_argument("Sequence contains no elements.");
+
+        return mean.Mean();
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Thrown by yield_return once nobody is interested in further values anymore.
+        // Deliberately not derived from std::exception, so that it unwinds the yielding function.
+        struct Cancellation { };
+    }
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <ucontext.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include "Cancellation.hpp"
+#include "RangeCursor.hpp"
+#include "Utility.hpp"
+#include "YieldStatistics.hpp"
+
+#ifndef LINQPP_YIELD_STACK_SIZE
+#define LINQPP_YIELD_STACK_SIZE (256 * 1024)
+#endif
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Runs the yielding function on its own stack within the caller's thread.
+        // Every handoff is a plain user-space context switch, no thread is involved.
+        template <class T>
+        class ContextController : public std::enable_shared_from_this<ContextController<T>>
+        {
+            enum class ContextStatus
+            {
+                Uninitialized,
+                ContextIsWorking,
+                CallerIsWorking,
+                ContextFinished,
+                ContextCancelled
+            };
+
+        private:
+            ucontext_t _callerContext;
+            ucontext_t _yieldingContext;
+            std::unique_ptr<char[]> _spStack;
+            std::function<void(std::weak_ptr<ContextController>)> _yieldingFunction;
+            std::weak_ptr<ContextController> _spSelf;
+            Utility::Optional<T> _currentValue;
+            std::unique_ptr<RangeCursor<T>> _spRange;
+            std::exception_ptr _spException;
+            ContextStatus _contextStatus = ContextStatus::Uninitialized;
+            std::shared_ptr<YieldStatistics> _spStatistics;
+
+        public:
+            // Batching brings no benefit without a thread to synchronize with, so the batch size is ignored.
+            explicit ContextController(size_t = 1) { }
+            ~ContextController() = default;
+
+            ContextController(ContextController const&) = delete;
+            ContextController(ContextController&&) = delete;
+            ContextController& operator=(ContextController const&) = delete;
+            ContextController& operator=(ContextController&&) = delete;
+
+        // Methods to be called from caller only
+        public:
+            template <class YieldingFunction>
+            void Initialize(YieldingFunction yieldingFunction)
+            {
+                if (_contextStatus != ContextStatus::Uninitialized)
+                    throw std::logic_error("Attempt to assign a new yielding context to already initialized context controller.");
+
+                _yieldingFunction = std::move(yieldingFunction);
+                _spSelf = this->shared_from_this();
+                _spStack = std::make_unique<char[]>(LINQPP_YIELD_STACK_SIZE);
+
+                if (getcontext(&_yieldingContext) != 0)
+                    throw std::runtime_error("Could not create yielding context.");
+
+                _yieldingContext.uc_stack.ss_sp = _spStack.get();
+                _yieldingContext.uc_stack.ss_size = LINQPP_YIELD_STACK_SIZE;
+                _yieldingContext.uc_link = &_callerContext;
+
+                auto address = reinterpret_cast<std::uintptr_t>(this);
+                makecontext(&_yieldingContext, reinterpret_cast<void(*)()>(&ContextController::Run), 2,
+                        static_cast<unsigned int>(address & 0xffffffffu), static_cast<unsigned int>(static_cast<std::uint64_t>(address) >> 32));
+
+                Resume();
+            }
+
+            bool IsInitialized() const { return _contextStatus != ContextStatus::Uninitialized; }
+
+            void SetStatistics(std::shared_ptr<YieldStatistics> spStatistics)
+            {
+                if (_contextStatus != ContextStatus::Uninitialized)
+                    throw std::logic_error("Statistics have to be set before the context controller is initialized.");
+
+                _spStatistics = std::move(spStatistics);
+            }
+
+            std::shared_ptr<YieldStatistics const> GetStatistics() const { return _spStatistics; }
+
+            T AwaitValueFromThread()
+            {
+                if (_contextStatus == ContextStatus::Uninitialized)
+                    throw std::runtime_error("Context controller has not been initialized yet.");
+
+                if (_spException)
+                    std::rethrow_exception(_spException);
+
+                if (_spRange)
+                    return _spRange->Get();
+
+                return std::move(*_currentValue);
+            }
+
+            void ContinueYieldingThread()
+            {
+                if (_contextStatus == ContextStatus::Uninitialized)
+                    throw std::runtime_error("Context controller has not been initialized yet.");
+
+                if (_spRange)
+                {
+                    _spRange->Increment();
+                    if (!_spRange->IsAtEnd())
+                        return;
+                }
+
+                if (_contextStatus == ContextStatus::ContextFinished)
+                    return;
+
+                Resume();
+
+                if (_spException)
+                    std::rethrow_exception(_spException);
+            }
+
+            bool IsFinished() const { return _contextStatus == ContextStatus::ContextFinished; }
+
+            // Unwinds the suspended yielding function, so that its stack can be freed. This may happen while the caller
+            // unwinds or handles an exception: the function never waits within a handler, and a Cancellation it throws
+            // is caught before control returns, which leaves the exception state of the thread as it was.
+            void Cancel()
+            {
+                if (_contextStatus != ContextStatus::CallerIsWorking)
+                    return;
+
+                _contextStatus = ContextStatus::ContextCancelled;
+                swapcontext(&_callerContext, &_yieldingContext);
+            }
+
+        // Methods to be called from yielding context only
+        public:
+            template <class _T>
+            void PassValueToCaller(_T&& t)
+            {
+                _currentValue.Emplace(std::forward<_T>(t));
+
+                if (_spStatistics)
+                    _spStatistics->AddValue();
+
+                WaitForCaller();
+            }
+
+            template <class Container>
+            void PassRangeToCaller(Container&& container)
+            {
+                _currentValue.Reset();
+                _spRange = CreateRangeCursor<T>(std::forward<Container>(container));
+                WaitForCaller();
+            }
+
+            void PassExceptionToCaller(std::exception_ptr spException)
+            {
+                // Nobody is left to take the exception once the function is cancelled, so it just finishes.
+                _spException = std::move(spException);
+                if (_contextStatus == ContextStatus::ContextCancelled)
+                    return;
+
+                _contextStatus = ContextStatus::CallerIsWorking;
+                SwitchToCaller();
+            }
+
+            // Returning from Run() switches back to the caller through uc_link.
+            void PassThreadFinishedNotificationToCaller() { _contextStatus = ContextStatus::ContextFinished; }
+
+        private:
+            // A cancelled function stays cancelled, even if it swallowed a Cancellation and yields again.
+            void WaitForCaller()
+            {
+                if (_contextStatus == ContextStatus::ContextCancelled)
+                    throw Cancellation();
+
+                _contextStatus = ContextStatus::CallerIsWorking;
+                SwitchToCaller();
+
+                if (_contextStatus == ContextStatus::ContextCancelled)
+                    throw Cancellation();
+            }
+
+            // Skips empty delegated ranges, so that the caller always gets a value, an exception or the end.
+            void Resume()
+            {
+                do
+                {
+                    _spRange.reset();
+                    _contextStatus = ContextStatus::ContextIsWorking;
+                    SwitchToContext();
+                } while (_spRange && _spRange->IsAtEnd() && _contextStatus == ContextStatus::CallerIsWorking);
+            }
+
+            // Switching to the other side only returns once it passes control back, which is the time measured.
+            void SwitchToCaller()
+            {
+                if (!_spStatistics)
+                {
+                    swapcontext(&_yieldingContext, &_callerContext);
+                    return;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                swapcontext(&_yieldingContext, &_callerContext);
+                _spStatistics->AddYieldingWait(std::chrono::steady_clock::now() - start);
+            }
+
+            void SwitchToContext()
+            {
+                if (!_spStatistics)
+                {
+                    swapcontext(&_callerContext, &_yieldingContext);
+                    return;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                swapcontext(&_callerContext, &_yieldingContext);
+                _spStatistics->AddCallerWait(std::chrono::steady_clock::now() - start);
+            }
+
+            static void Run(unsigned int addressLow, unsigned int addressHigh)
+            {
+                auto address = (static_cast<std::uint64_t>(addressHigh) << 32) | addressLow;
+                auto pThis = reinterpret_cast<ContextController*>(static_cast<std::uintptr_t>(address));
+
+                auto yieldingFunction = std::move(pThis->_yieldingFunction);
+                yieldingFunction(std::move(pThis->_spSelf));
+            }
+        };
+    }
+}
@@ -14,11 +14,24 @@ namespace Linqpp
 
         template <class T>
         static auto Repeat(T t, size_t n);
+
+        // Infinite sequence of next(state), next(state), ... where next may modify the state.
+        template <class State, class Next>
+        static auto Generate(State seed, Next next);
+
+        // Sequence of step(state) as long as it returns a non-empty Utility::Optional, step may modify the state.
+        template <class State, class Step>
+        static auto Unfold(State state, Step step);
+
+        // Infinite sequence of seed, f(seed), f(f(seed)), ...
+        template <class T, class Function>
+        static auto Iterate(T seed, Function f);
     };
 }
 
 #include "From.hpp"
 #include "iterator/IntIterator.hpp"
+#include "iterator/UnfoldIterator.hpp"
 
 #include <array>
 
@@ -41,4 +54,33 @@ namespace Linqpp
     {
         return Range((size_t)0, n).Select([=](size_t) { return t; });
     }
+
+    template <class State, class Next>
+    auto Enumerable::Generate(State seed, Next next)
+    {
+        return Unfold(std::move(seed), [next = std::move(next)](State& state) mutable
+        {
+            return Utility::Optional<std::decay_t<decltype(next(state))>>(next(state));
+        });
+    }
+
+    template <class State, class Step>
+    auto Enumerable::Unfold(State state, Step step)
+    {
+        return From(CreateUnfoldIterator(state, step), CreateUnfoldIterator(state, step, true));
+    }
+
+    template <class T, class Function>
+    auto Enumerable::Iterate(T seed, Function f)
+    {
+        // f is only applied once the next element is actually requested.
+        return Unfold(std::make_pair(std::move(seed), false), [f = std::move(f)](std::pair<T, bool>& state) mutable
+        {
+            if (state.second)
+                state.first = f(state.first);
+
+            state.second = true;
+            return Utility::Optional<T>(state.first);
+        });
+    }
 }
@@ -5,17 +5,17 @@
 
 namespace Linqpp
 {
-    template <class InputIterator>
+    template <class InputIterator, class Derived>
     class IEnumerable;
 
     template <class Container>
-    class ExtendingEnumerable : public Container, public IEnumerable<Utility::Iterator<Container>>
+    class ExtendingEnumerable : public Container, public IEnumerable<Utility::Iterator<Container>, ExtendingEnumerable<Container>>
     {
     public:
         using Container::Container;
 
     public:
-        virtual Utility::Iterator<Container> begin() const override { return Container::begin(); }
-        virtual Utility::Iterator<Container> end() const override { return Container::end(); }
+        Utility::Iterator<Container> begin() const { return Container::begin(); }
+        Utility::Iterator<Container> end() const { return Container::end(); }
     };
 }
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Utility.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        template <class Iterator, class Sink>
+        auto InternalForEach(Iterator const& first, Iterator const& last, Sink& sink, int) -> decltype(first.ForEach(last, sink))
+        {
+            return first.ForEach(last, sink);
+        }
+
+        template <class Iterator, class Sink>
+        bool InternalForEach(Iterator first, Iterator const& last, Sink& sink, ...)
+        {
+            for (; first != last; ++first)
+            {
+                if (!sink(*first))
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    // Pushes the elements of [first, last) into sink until it returns false, and returns false in that case.
+    // Linqpp iterators provide a ForEach(last, sink) member that forwards to the iterators they wrap,
+    // so a whole pipeline runs as a single loop over its source. Others are iterated as usual.
+    template <class InputIterator, class Sink>
+    bool ForEach(InputIterator const& first, InputIterator const& last, Sink&& sink)
+    {
+        return Detail::InternalForEach(first, last, sink, 0);
+    }
+
+    namespace Detail
+    {
+        // Lets sinks that return nothing take every element.
+        template <class Sink, class... T>
+        auto Continue(Sink& sink, T&&... t) -> std::enable_if_t<std::is_void<decltype(sink(std::forward<T>(t)...))>::value, bool>
+        {
+            sink(std::forward<T>(t)...);
+            return true;
+        }
+
+        template <class Sink, class... T>
+        auto Continue(Sink& sink, T&&... t) -> std::enable_if_t<!std::is_void<decltype(sink(std::forward<T>(t)...))>::value, bool>
+        {
+            return static_cast<bool>(sink(std::forward<T>(t)...));
+        }
+
+        // Keeps an element pushed into a sink beyond the sink call:
+        // the address of references into the source, a copy of values produced on the fly.
+        template <class Reference, bool = std::is_lvalue_reference<Reference>::value>
+        class ElementHolder
+        {
+        private:
+            std::remove_reference_t<Reference>* _pElement = nullptr;
+
+        public:
+            bool HasValue() const { return _pElement != nullptr; }
+            void Set(Reference element) { _pElement = std::addressof(element); }
+            Reference Get() const { return *_pElement; }
+            Reference Take() const { return *_pElement; }
+        };
+
+        template <class Reference>
+        class ElementHolder<Reference, false>
+        {
+        private:
+            Utility::Optional<std::decay_t<Reference>> _element;
+
+        public:
+            bool HasValue() const { return _element.HasValue(); }
+
+            template <class T>
+            void Set(T&& element) { _element.Emplace(std::forward<T>(element)); }
+
+            std::decay_t<Reference> const& Get() const { return *_element; }
+            std::decay_t<Reference> Take() { return std::move(*_element); }
+        };
+
+        // Holds elements of iterators of the given type. References of input iterators may point into the iterator itself,
+        // e.g. for std::istream_iterator, so that their elements are copied.
+        template <class Iterator, class Reference = typename std::iterator_traits<Iterator>::reference>
+        using IteratorElementHolder = ElementHolder<Reference, std::is_lvalue_reference<Reference>::value
+            && std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value>;
+
+        template <class Holder>
+        decltype(auto) TakeElement(Holder& holder)
+        {
+            if (!holder.HasValue())
+                throw std::invalid_argument("Sequence contains no matching element.");
+
+            return holder.Take();
+        }
+    }
+
+    // Block iteration
+    namespace Detail
+    {
+        // Upper bound of the number of elements passed to a block sink at once.
+        constexpr size_t BlockSize = 256;
+
+        // Element types that are passed in blocks. Operators keep blocks in stack buffers of these.
+        template <class Reference, class T = std::decay_t<Reference>>
+        using IsBlockElement = std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>;
+
+        template <class Iterator, class T = std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type>>
+        using IsContiguous = std::integral_constant<bool, IsBlockElement<T>::value
+            && (std::is_pointer<Iterator>::value
+                || std::is_same<Iterator, typename std::vector<T>::iterator>::value
+                || std::is_same<Iterator, typename std::vector<T>::const_iterator>::value)>;
+
+        template <class Iterator, class BlockSink>
+        auto InternalForEachBlock(Iterator const& first, Iterator const& last, BlockSink& sink, int) -> decltype(first.ForEachBlock(last, sink))
+        {
+            return first.ForEachBlock(last, sink);
+        }
+
+        template <class Iterator, class BlockSink>
+        auto InternalForEachBlock(Iterator const& first, Iterator const& last, BlockSink& sink, long) -> std::enable_if_t<IsContiguous<Iterator>::value, bool>
+        {
+            if (first == last)
+                return true;
+
+            auto const* values = std::addressof(*first);
+            for (size_t offset = 0, size = last - first; offset < size; offset += BlockSize)
+            {
+                if (!sink(values + offset, std::min(BlockSize, size - offset)))
+                    return false;
+            }
+
+            return true;
+        }
+
+        template <class Iterator, class BlockSink>
+        bool InternalForEachBlock(Iterator const& first, Iterator const& last, BlockSink& sink, ...)
+        {
+            using T = std::decay_t<decltype(*first)>;
+
+            T buffer[BlockSize];
+            size_t count = 0;
+
+            auto result = Linqpp::ForEach(first, last, [&](auto const& value)
+            {
+                buffer[count++] = value;
+                if (count < BlockSize)
+                    return true;
+
+                count = 0;
+                return static_cast<bool>(sink(static_cast<T const*>(buffer), BlockSize));
+            });
+
+            return result && (count == 0 || sink(static_cast<T const*>(buffer), count));
+        }
+    }
+
+    // Pushes the elements of [first, last) into sink(values, count) in blocks of at most Detail::BlockSize elements,
+    // until it returns false, and returns false in that case. Blocks are never empty.
+    // Elements must be arithmetic. Contiguous sources are passed without copying, and Linqpp iterators provide
+    // a ForEachBlock(last, sink) member that runs their operator over a whole block in a tight loop.
+    // Others are collected through ForEach. Operators may run up to a block ahead of a sink that stops early.
+    template <class InputIterator, class BlockSink>
+    bool ForEachBlock(InputIterator const& first, InputIterator const& last, BlockSink&& sink)
+    {
+        static_assert(Detail::IsBlockElement<decltype(*first)>::value, "Only arithmetic elements are passed in blocks.");
+
+        return Detail::InternalForEachBlock(first, last, sink, 0);
+    }
+}
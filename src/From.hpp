@@ -11,13 +11,21 @@ namespace Linqpp
         return IteratorEnumerable<InputIterator>(first, last);
     }
 
-    template <class Container, class = std::enable_if_t<!std::is_convertible<std::remove_reference_t<Container>*, IEnumerable<Utility::Iterator<Container>>*>::value>>
+    namespace Detail
+    {
+        template <class Container, class Type = std::remove_cv_t<std::remove_reference_t<Container>>>
+        using IsEnumerable = std::integral_constant<bool,
+              std::is_convertible<Type*, IEnumerable<Utility::Iterator<Container>>*>::value
+              || std::is_convertible<Type*, IEnumerable<Utility::Iterator<Container>, Type>*>::value>;
+    }
+
+    template <class Container, class = std::enable_if_t<!Detail::IsEnumerable<Container>::value>>
     auto From(Container&& container)
     {
         return From(std::begin(std::forward<Container>(container)), std::end(std::forward<Container>(container)));
     }
 
-    template <class Container, class = std::enable_if_t<std::is_convertible<std::remove_reference_t<Container>*, IEnumerable<Utility::Iterator<Container>>*>::value>>
+    template <class Container, class = std::enable_if_t<Detail::IsEnumerable<Container>::value>>
     auto&& From(Container&& container)
     {
         return std::forward<Container>(container);
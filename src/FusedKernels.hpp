@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ForEach.hpp"
+#include "iterator/SelectIterator.hpp"
+#include "iterator/ZipIterator.hpp"
+#include "Reduction.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace Linqpp
+{
+    // Pipeline shapes over contiguous arithmetic sources that run as a single kernel,
+    // recognized by their iterator types. All other pipelines take the generic path.
+    namespace Detail
+    {
+        // Address of the element that a contiguous iterator refers to.
+        template <class Iterator, class = std::enable_if_t<IsContiguous<Iterator>::value>>
+        auto ContiguousData(Iterator const& iterator) { return std::addressof(*iterator); }
+
+        // Zip(values, std::multiplies<T>()).Sum() is a dot product. The products go through the zip's multiplies,
+        // so that a T other than the element types converts them as it does on the generic path.
+        template <class Iterator1, class Iterator2, class T, class Sum>
+        auto Reduce(ZipIterator<Iterator1, Iterator2, std::multiplies<T>> const& first,
+                ZipIterator<Iterator1, Iterator2, std::multiplies<T>> const& last, SumReduction<Sum> reduction)
+            -> std::enable_if_t<IsContiguous<Iterator1>::value && IsContiguous<Iterator2>::value, SumReduction<Sum>>
+        {
+            auto count = static_cast<size_t>(last - first);
+            if (count != 0)
+                RunKernel([&] { reduction.AddProducts(ContiguousData(first.GetIterator1()), ContiguousData(first.GetIterator2()), count, first.GetFunction()); });
+
+            return reduction;
+        }
+
+        // Select(function) followed by a reduction such as Sum, Max or Average transforms and reduces in a single kernel.
+        template <class Iterator, class UnaryFunction, bool IsCaching, class Reduction>
+        auto Reduce(SelectIterator<Iterator, UnaryFunction, IsCaching> const& first, SelectIterator<Iterator, UnaryFunction, IsCaching> const& last,
+                Reduction reduction)
+            -> std::enable_if_t<IsContiguous<Iterator>::value && IsBlockElement<decltype(*first)>::value, Reduction>
+        {
+            auto count = static_cast<size_t>(last - first);
+            if (count == 0)
+                return reduction;
+
+            auto const* values = ContiguousData(first.GetIterator());
+            auto const& function = first.GetFunction();
+
+            RunKernel([&]
+            {
+                std::decay_t<decltype(*first)> buffer[BlockSize];
+                for (size_t offset = 0; offset < count; offset += BlockSize)
+                {
+                    auto blockCount = std::min(BlockSize, count - offset);
+                    for (size_t i = 0; i < blockCount; ++i)
+                        buffer[i] = function(values[offset + i]);
+
+                    reduction.Add(static_cast<std::decay_t<decltype(*first)> const*>(buffer), blockCount);
+                }
+            });
+
+            return reduction;
+        }
+
+        // Copies the elements between first and last into a new Vector.
+        template <class Vector, class Iterator>
+        Vector Collect(Iterator const& first, Iterator const& last) { return Vector(first, last); }
+
+        // Select(function).ToVector() transforms and writes in a single kernel, e.g. a SAXPY for an affine function.
+        // The vector is constructed from the range as on the generic path, so that every element is written once.
+        template <class Vector, class Iterator, class UnaryFunction, bool IsCaching>
+        auto Collect(SelectIterator<Iterator, UnaryFunction, IsCaching> const& first, SelectIterator<Iterator, UnaryFunction, IsCaching> const& last)
+            -> std::enable_if_t<IsContiguous<Iterator>::value && IsBlockElement<decltype(*first)>::value, Vector>
+        {
+            Vector vector;
+            RunKernel([&] { vector = Vector(first, last); });
+            return vector;
+        }
+    }
+}
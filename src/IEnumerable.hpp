@@ -7,21 +7,27 @@
 #include <set>
 #include <vector>
 
+#include "Average.hpp"
 #include "Distinct.hpp"
 #include "ElementAt.hpp"
 #include "Enumerable.hpp"
 #include "ExtendingEnumerable.hpp"
+#include "ForEach.hpp"
 #include "From.hpp"
+#include "FusedKernels.hpp"
 #include "iterator/ConcatIterator.hpp"
+#include "iterator/MemoizingIterator.hpp"
 #include "iterator/OwningIterator.hpp"
 #include "iterator/SelectIterator.hpp"
 #include "iterator/SkipWhileIterator.hpp"
-#include "iterator/SortingIterator.hpp"
 #include "iterator/TakeIterator.hpp"
 #include "iterator/WhereIterator.hpp"
 #include "iterator/ZipIterator.hpp"
 #include "Last.hpp"
 #include "MinMax.hpp"
+#include "OrderedEnumerable.hpp"
+#include "Reduction.hpp"
+#include "Size.hpp"
 #include "Skip.hpp"
 #include "Utility.hpp"
 
@@ -31,13 +37,49 @@ namespace Linqpp
     auto From(InputIterator first, InputIterator last);
 
     template <class InputIterator>
-    class IEnumerable
+    class IteratorEnumerable;
+
+    template <class Source>
+    class ErasedEnumerable;
+
+    namespace Detail
+    {
+        template <class InputIterator>
+        class VirtualRange
+        {
+        protected:
+            VirtualRange() = default;
+            VirtualRange(VirtualRange const&) = default;
+            VirtualRange(VirtualRange&&) = default;
+            VirtualRange& operator=(VirtualRange const&) = default;
+            VirtualRange& operator=(VirtualRange&&) = default;
+
+        public:
+            virtual ~VirtualRange() = default;
+
+        public:
+            virtual InputIterator begin() const = 0;
+            virtual InputIterator end() const = 0;
+        };
+
+        struct StaticRange { };
+    }
+
+    // IEnumerable<InputIterator, Derived> is the static variant: Derived provides begin() and end(),
+    // which are called without virtual dispatch. All enumerables of Linqpp are of this kind.
+    // IEnumerable<InputIterator> declares begin() and end() pure virtual instead.
+    // AsEnumerable() turns any enumerable into one of those, e.g. to pass it by reference to the interface.
+    template <class InputIterator, class Derived = void>
+    class IEnumerable : public std::conditional_t<std::is_void<Derived>::value, Detail::VirtualRange<InputIterator>, Detail::StaticRange>
     {
     public:
         using value_type = typename std::iterator_traits<InputIterator>::value_type;
         using iterator_category = typename std::iterator_traits<InputIterator>::iterator_category;
         using iterator = InputIterator;
 
+    private:
+        using Self = std::conditional_t<std::is_void<Derived>::value, IEnumerable, Derived>;
+
     protected:
         IEnumerable() = default;
         IEnumerable(IEnumerable const&) = default;
@@ -46,24 +88,45 @@ namespace Linqpp
         IEnumerable& operator=(IEnumerable&&) = default;
 
     public:
-        virtual ~IEnumerable() = default;
+        ~IEnumerable() = default;
 
-    public:
-        virtual InputIterator begin() const = 0;
-        virtual InputIterator end() const = 0;
+    private:
+        Self const& This() const { return static_cast<Self const&>(*this); }
 
     public:
+        auto AsEnumerable() const { return InternalAsEnumerable(std::is_void<Derived>()); }
+
         template <class BinaryFunction>
         auto Aggregate(BinaryFunction binaryFunction) const
         {
-            decltype(auto) first = First();
-            return std::accumulate(std::next(begin()), end(), first, binaryFunction);
+            Utility::Optional<std::decay_t<decltype(*This().begin())>> result;
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value)
+            {
+                if (result.HasValue())
+                    *result = binaryFunction(*result, std::forward<decltype(value)>(value));
+                else
+                    result.Emplace(std::forward<decltype(value)>(value));
+
+                return true;
+            });
+
+            if (!result.HasValue())
+                throw std::invalid_argument("Sequence contains no elements.");
+
+            return std::move(*result);
         }
 
         template <class Seed, class BinaryFunction>
         auto Aggregate(Seed const& seed, BinaryFunction binaryFunction) const
         {
-            return std::accumulate(begin(), end(), seed, binaryFunction);
+            auto result = seed;
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value)
+            {
+                result = binaryFunction(result, std::forward<decltype(value)>(value));
+                return true;
+            });
+
+            return result;
         }
 
         template <class Seed, class BinaryFunction, class ResultSelector>
@@ -72,35 +135,32 @@ namespace Linqpp
             return resultSelector(Aggregate(seed, binaryFunction));
         }
 
-        bool Any() const { return begin() != end(); }
+        bool Any() const { return This().begin() != This().end(); }
 
         template <class Predicate> 
-        bool Any(Predicate predicate) const { return std::any_of(begin(), end(), predicate); }
+        bool Any(Predicate predicate) const
+        {
+            return !Linqpp::ForEach(This().begin(), This().end(), [&](auto const& value) { return !predicate(value); });
+        }
 
         template <class Predicate> 
-        bool All(Predicate predicate) const { return std::all_of(begin(), end(), predicate); }
-
-        auto Average() const
+        bool All(Predicate predicate) const
         {
-            double n = 1;
-            auto avg = First() * n;
-            for (auto const& i : Skip(1))
-            {
-                avg *= n / (n + 1);
-                n += 1;
-                avg += i / n;
-            }
-
-            return avg;
+            return Linqpp::ForEach(This().begin(), This().end(), [&](auto const& value) { return static_cast<bool>(predicate(value)); });
         }
 
+        auto Average() const { return Linqpp::Average(This().begin(), This().end()); }
+
+        template <class UnaryFunction>
+        auto Average(UnaryFunction unaryFunction) const { return Select(unaryFunction).Average(); }
+
         template <class Container>
         auto Concat(Container&& container) const
         {
             auto cBegin = std::begin(std::forward<Container>(container));
             auto cEnd = std::end(std::forward<Container>(container));
-            auto first = CreateConcatIterator(begin(), end(), cBegin, cBegin);
-            auto last = CreateConcatIterator(end(), end(), cBegin, cEnd);
+            auto first = CreateConcatIterator(This().begin(), This().end(), cBegin, cBegin);
+            auto last = CreateConcatIterator(This().end(), This().end(), cBegin, cEnd);
 
             return From(first, last);
         }
@@ -111,51 +171,78 @@ namespace Linqpp
         template <class T, class EqualityComparer>
         auto Contains(T const& t, EqualityComparer comparer) const { return Any([&](const auto& t2) { return comparer(t, t2); }); }
 
-        size_t Count() const { return std::distance(begin(), end()); }
+        size_t Count() const
+        {
+            size_t size;
+            return TryGetSize(size) ? size : InternalCount(Detail::IsBlockElement<decltype(*This().begin())>());
+        }
 
         template <class Predicate>
-        size_t Count(Predicate predicate) const { return std::count_if(begin(), end(), predicate); }
+        size_t Count(Predicate predicate) const { return InternalCount(predicate, Detail::IsBlockElement<decltype(*This().begin())>()); }
 
         auto DefaultIfEmpty() const { return DefaultIfEmpty(value_type{}); }
 
         auto DefaultIfEmpty(value_type const& value) const { return Concat(Enumerable::Repeat(value, Any() ? 0 : 1)); }
 
-        auto Distinct() const { return Linqpp::Distinct(begin(), end()); }
+        auto Distinct() const { return Linqpp::Distinct(This().begin(), This().end()); }
 
         template <class LessThanComparer>
-        auto Distinct(LessThanComparer comparer) const { return Linqpp::Distinct(begin(), end(), comparer); }
+        auto Distinct(LessThanComparer comparer) const { return Linqpp::Distinct(This().begin(), This().end(), comparer); }
 
         template <class EqualityComparer, class Hash>
         auto Distinct(EqualityComparer comparer, Hash hash) const
         {
-            return Linqpp::Distinct(begin(), end(), comparer, hash);
+            return Linqpp::Distinct(This().begin(), This().end(), comparer, hash);
         }
 
         template <class TargetType>
         auto DynamicCast() const { return InternalDynamicCast<TargetType>(nullptr); }
         
-        decltype(auto) ElementAt(int64_t i) const { return Linqpp::ElementAt(begin(), i, iterator_category()); }
+        decltype(auto) ElementAt(int64_t i) const { return Linqpp::ElementAt(This().begin(), i, iterator_category()); }
 
-        value_type ElementAtOrDefault(int64_t i) const { return Linqpp::ElementAtOrDefault(begin(), end(), i, iterator_category()); }
+        value_type ElementAtOrDefault(int64_t i) const
+        {
+            if (i < 0 || static_cast<uint64_t>(i) >= SizeHint())
+                return { };
 
-        decltype(auto) First() const { return *begin(); }
+            return Linqpp::ElementAtOrDefault(This().begin(), This().end(), i, iterator_category());
+        }
+
+        decltype(auto) First() const { return *This().begin(); }
 
         template <class Predicate>
-        decltype(auto) First(Predicate predicate) const { return *std::find_if(begin(), end(), predicate); }
+        decltype(auto) First(Predicate predicate) const
+        {
+            auto found = InternalFind(predicate);
+            return Detail::TakeElement(found);
+        }
 
         value_type FirstOrDefault() const { return Any() ? First() : value_type(); }
 
         template <class Predicate>
         value_type FirstOrDefault(Predicate predicate) const 
         {
-            auto found = std::find_if(begin(), end(), predicate);
-            return found != end() ? *found : value_type();
+            auto found = InternalFind(predicate);
+            return found.HasValue() ? value_type(found.Take()) : value_type();
+        }
+
+        template <class Sink>
+        bool ForEach(Sink sink) const
+        {
+            return Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value) { return Detail::Continue(sink, std::forward<decltype(value)>(value)); });
+        }
+
+        // Passes arithmetic elements in blocks, see Linqpp::ForEachBlock.
+        template <class BlockSink>
+        bool ForEachBlock(BlockSink sink) const
+        {
+            return Linqpp::ForEachBlock(This().begin(), This().end(), [&](auto const* values, size_t count) { return Detail::Continue(sink, values, count); });
         }
 
         decltype(auto) Last() const { return Last([](auto) { return true; }); }
 
         template <class Predicate>
-        decltype(auto) Last(Predicate predicate) const { return Linqpp::Last(begin(), end(), predicate, iterator_category()); }
+        decltype(auto) Last(Predicate predicate) const { return Linqpp::Last(This().begin(), This().end(), predicate, iterator_category()); }
 
         value_type LastOrDefault() const { return Any() ? Last() : value_type(); }
 
@@ -163,26 +250,33 @@ namespace Linqpp
         value_type LastOrDefault(Predicate predicate) const
         {
             value_type defaultValue = value_type();
-            return Linqpp::Last(begin(), end(), predicate, iterator_category(), &defaultValue);
+            return Linqpp::Last(This().begin(), This().end(), predicate, iterator_category(), &defaultValue);
         }
 
-        decltype(auto) Max() const { return Linqpp::Max(begin(), end()); }
+        decltype(auto) Max() const { return Linqpp::Max(This().begin(), This().end()); }
 
         template <class UnaryFunction>
         decltype(auto) Max(UnaryFunction unaryFunction) const { return Select(unaryFunction).Max(); }
 
-        decltype(auto) Min() const { return Linqpp::Min(begin(), end()); }
+        auto Memoize() const { return CreateMemoizingEnumerable(This().begin(), This().end()); }
+
+        decltype(auto) Min() const { return Linqpp::Min(This().begin(), This().end()); }
 
         template <class UnaryFunction>
         decltype(auto) Min(UnaryFunction unaryFunction) const { return Select(unaryFunction).Min(); }
 
+        auto MinMax() const { return Linqpp::MinMax(This().begin(), This().end()); }
+
+        template <class UnaryFunction>
+        auto MinMax(UnaryFunction unaryFunction) const { return Select(unaryFunction).MinMax(); }
+
         template <class UnaryFunction>
         auto OrderBy(UnaryFunction unaryFunction) const { return OrderBy(unaryFunction, std::less<>()); }
 
         template <class UnaryFunction, class LessThanComparer>
         auto OrderBy(UnaryFunction unaryFunction, LessThanComparer comparer) const 
         { 
-            return CreateSortedEnumerable(begin(), end(), [=] (auto const& t1, auto const& t2) { return comparer(unaryFunction(t1), unaryFunction(t2)); });
+            return CreateSortedEnumerable(This().begin(), This().end(), unaryFunction, comparer);
         }
 
         template <class UnaryFunction>
@@ -199,63 +293,81 @@ namespace Linqpp
         template <class UnaryFunction>
         auto Select(UnaryFunction unaryFunction) const { return InternalSelect(unaryFunction, nullptr); }
 
+        // Like Select, but each result is computed once per position, even if it is dereferenced repeatedly,
+        // e.g. by a following Where and then by its consumer. Meant for expensive functions such as parsers.
+        template <class UnaryFunction>
+        auto SelectCached(UnaryFunction unaryFunction) const
+        {
+            return From(CreateSelectIterator<true>(This().begin(), unaryFunction), CreateSelectIterator<true>(This().end(), unaryFunction));
+        }
+
         template <class Container>
         auto SequenceEqual(Container&& container) const
         {
-            return std::equal(begin(), end(), std::begin(std::forward<Container>(container)), std::end(std::forward<Container>(container)));
+            return std::equal(This().begin(), This().end(), std::begin(std::forward<Container>(container)), std::end(std::forward<Container>(container)));
         }
 
         template <class Container, class EqualityComparer>
         auto SequenceEqual(Container&& container, EqualityComparer comparer) const
         {
-            return std::equal(begin(), end(),
+            return std::equal(This().begin(), This().end(),
                     std::begin(std::forward<Container>(container)), std::end(std::forward<Container>(container)),
                     comparer);
         }
 
-        auto Skip(size_t n) const { return GetEnumerableFromSkip(begin(), end(), n); }
+        auto Skip(size_t n) const { return GetEnumerableFromSkip(This().begin(), This().end(), n); }
 
         template <class Predicate> 
-        auto SkipWhile(Predicate predicate) const { return GetEnumerableFromSkipWhile(begin(), end(), predicate); }
+        auto SkipWhile(Predicate predicate) const { return GetEnumerableFromSkipWhile(This().begin(), This().end(), predicate); }
 
         template <class TargetType>
         auto StaticCast() const { return InternalStaticCast<TargetType>(nullptr); }
 
-        auto Sum() const { return Aggregate(std::plus<>()); }
+        auto Sum() const { return InternalSum(Detail::IsBlockElement<decltype(*This().begin())>()); }
 
         template <class UnaryFunction>
         auto Sum(UnaryFunction unaryFunction) const { return Select(unaryFunction).Sum(); }
 
-        auto Take(size_t n) const { return GetEnumerableFromTake(begin(), n, end()); }
+        // Like Sum, but returns integers as 64 bit values, so sums of smaller types do not overflow.
+        auto SumWide() const { return InternalSumWide(Detail::IsBlockElement<decltype(*This().begin())>()); }
+
+        template <class UnaryFunction>
+        auto SumWide(UnaryFunction unaryFunction) const { return Select(unaryFunction).SumWide(); }
+
+        // Upper bound of the number of elements that is known without enumerating them, e.g. the size of the source
+        // for Where or Distinct. std::numeric_limits<size_t>::max() if there is none.
+        size_t SizeHint() const { return Detail::GetSizeBound(This()).MaxSize(); }
+
+        auto Take(size_t n) const { return GetEnumerableFromTake(This().begin(), n, This().end()); }
 
         template <class KeySelector>
         auto ToMap(KeySelector keySelector) const
         {
-            using Key = decltype(keySelector(*begin()));
+            using Key = decltype(keySelector(*This().begin()));
             return ToMap(keySelector, std::less<Key>());
         }
 
         template <class KeySelector, class KeyComparer,
-                 class Key = decltype(std::declval<KeySelector>()(*std::declval<IEnumerable>().begin())),
-                 class = decltype(std::declval<KeyComparer>()(*std::declval<IEnumerable>().begin(), *std::declval<IEnumerable>().begin()))>
+                 class Key = decltype(std::declval<KeySelector>()(*std::declval<InputIterator>())),
+                 class = decltype(std::declval<KeyComparer>()(*std::declval<InputIterator>(), *std::declval<InputIterator>()))>
         auto ToMap(KeySelector keySelector, KeyComparer keyComparer) const
         { 
             auto keyValuePairs = Select([=](value_type const& v) { return std::make_pair(keySelector(v), v); });
             return ExtendingEnumerable<std::map<Key, value_type, KeyComparer>>(keyValuePairs.begin(), keyValuePairs.end(), keyComparer);
         }
 
-        template <class KeySelector, class ValueSelector, class = decltype(std::declval<ValueSelector>()(*std::declval<IEnumerable>().begin()))> 
+        template <class KeySelector, class ValueSelector, class = decltype(std::declval<ValueSelector>()(*std::declval<InputIterator>()))> 
         auto ToMap(KeySelector keySelector, ValueSelector valueSelector) const
         {
-            using Key = decltype(keySelector(*begin()));
+            using Key = decltype(keySelector(*This().begin()));
             return ToMap(keySelector, valueSelector, std::less<Key>());
         }
 
         template <class KeySelector, class ValueSelector, class KeyComparer>
         auto ToMap(KeySelector keySelector, ValueSelector valueSelector, KeyComparer keyComparer) const
         {
-            using Key = decltype(keySelector(*begin()));
-            using Value = decltype(valueSelector(*begin()));
+            using Key = decltype(keySelector(*This().begin()));
+            using Value = decltype(valueSelector(*This().begin()));
 
             auto keyValuePairs = Select([=](value_type const& v) { return std::make_pair(keySelector(v), valueSelector(v)); });
             return ExtendingEnumerable<std::map<Key, Value, KeyComparer>>(keyValuePairs.begin(), keyValuePairs.end(), keyComparer);
@@ -267,12 +379,30 @@ namespace Linqpp
         auto ToSet(LessThanComparer comparer) const
         {
             ExtendingEnumerable<std::set<value_type, LessThanComparer>> result(comparer);
-            for (auto const& value : *this)
-                result.insert(value);
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value)
+            {
+                result.insert(std::forward<decltype(value)>(value));
+                return true;
+            });
+
             return result;
         }
 
-        auto ToVector() const { return ExtendingEnumerable<std::vector<value_type>>(begin(), end()); }
+        auto ToVector() const { return ToVector(0); }
+
+        // Reserves capacityHint elements up front unless the exact size is known anyway, see TryGetSize.
+        auto ToVector(size_t capacityHint) const { return InternalToVector(capacityHint, iterator_category()); }
+
+        // Gets the number of elements if it is known without enumerating them, which is the case for containers
+        // and random access sequences, and for Select, Concat, Zip, Take, Skip or Reverse of the latter.
+        bool TryGetSize(size_t& size) const
+        {
+            auto bound = Detail::GetSizeBound(This());
+            if (bound.IsExact())
+                size = bound.Size();
+
+            return bound.IsExact();
+        }
 
         template <class Container>
         auto Union(Container&& container) const { return Concat(std::forward<Container>(container)).Distinct(); }
@@ -299,35 +429,147 @@ namespace Linqpp
             auto cEnd = std::end(std::forward<Container>(container));
             using cCategory = typename std::iterator_traits<Utility::Iterator<Container>>::iterator_category;
 
-            return CreateZipEnumerable(begin(), end(), iterator_category(), cBegin, cEnd, cCategory(), binaryFunction);
+            return CreateZipEnumerable(This().begin(), This().end(), iterator_category(), cBegin, cEnd, cCategory(), binaryFunction);
         }
 
     private:
+        auto InternalAsEnumerable(std::true_type) const { return ErasedEnumerable<IteratorEnumerable<InputIterator>>(From(This().begin(), This().end())); }
+        auto InternalAsEnumerable(std::false_type) const { return ErasedEnumerable<Derived>(This()); }
+
+        template <class Predicate>
+        size_t InternalCount(Predicate& predicate, std::true_type) const
+        {
+            return Detail::Reduce(This().begin(), This().end(), Detail::CountReduction<Predicate>(predicate)).Result();
+        }
+
+        template <class Predicate>
+        size_t InternalCount(Predicate& predicate, std::false_type) const
+        {
+            size_t count = 0;
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto const& value)
+            {
+                if (predicate(value))
+                    ++count;
+                return true;
+            });
+
+            return count;
+        }
+
+        size_t InternalCount(std::true_type) const
+        {
+            size_t count = 0;
+            Linqpp::ForEachBlock(This().begin(), This().end(), [&](auto const*, size_t blockCount) { count += blockCount; return true; });
+            return count;
+        }
+
+        size_t InternalCount(std::false_type) const
+        {
+            size_t count = 0;
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto const&) { ++count; return true; });
+            return count;
+        }
+
+        template <class Predicate>
+        auto InternalFind(Predicate& predicate) const
+        {
+            Detail::IteratorElementHolder<decltype(This().begin()), decltype(*This().begin())> found;
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value)
+            {
+                if (!predicate(value))
+                    return true;
+
+                found.Set(std::forward<decltype(value)>(value));
+                return false;
+            });
+
+            return found;
+        }
+
+        auto InternalToVector(size_t, std::random_access_iterator_tag) const
+        {
+            return Detail::Collect<ExtendingEnumerable<std::vector<value_type>>>(This().begin(), This().end());
+        }
+
+        auto InternalToVector(size_t capacityHint, std::input_iterator_tag) const
+        {
+            ExtendingEnumerable<std::vector<value_type>> result;
+            bool isEstimated = Detail::Reserve(result, Detail::GetSizeBound(This()), capacityHint);
+
+            InternalAppend(result, Detail::IsBlockElement<decltype(*This().begin())>());
+
+            if (isEstimated)
+                Detail::ShrinkUnused(result);
+
+            return result;
+        }
+
+        template <class Vector>
+        void InternalAppend(Vector& vector, std::true_type) const
+        {
+            Linqpp::ForEachBlock(This().begin(), This().end(), [&](auto const* values, size_t count)
+            {
+                vector.insert(vector.end(), values, values + count);
+                return true;
+            });
+        }
+
+        template <class Vector>
+        void InternalAppend(Vector& vector, std::false_type) const
+        {
+            Linqpp::ForEach(This().begin(), This().end(), [&](auto&& value)
+            {
+                vector.emplace_back(std::forward<decltype(value)>(value));
+                return true;
+            });
+        }
+
+        auto InternalSum(std::false_type) const { return Aggregate(std::plus<>()); }
+
+        auto InternalSum(std::true_type) const
+        {
+            using T = std::decay_t<decltype(*This().begin())>;
+            return static_cast<T>(InternalSumWide(std::true_type()));
+        }
+
+        auto InternalSumWide(std::false_type) const { return Sum(); }
+
+        auto InternalSumWide(std::true_type) const
+        {
+            using T = std::decay_t<decltype(*This().begin())>;
+
+            auto sum = Detail::Reduce(This().begin(), This().end(), Detail::SumReduction<T>());
+            if (sum.IsEmpty())
+                throw std::invalid_argument("Sequence contains no elements.");
+
+            return sum.Result();
+        }
+
         template <class TargetType>
         auto InternalDynamicCast(std::enable_if_t<std::is_reference<TargetType>::value>*) const
         {
             auto caster = [](value_type& t) -> TargetType { return dynamic_cast<TargetType>(t); };
-            return From(CreateSelectIterator(begin(), caster), CreateSelectIterator(end(), caster));
+            return From(CreateSelectIterator(This().begin(), caster), CreateSelectIterator(This().end(), caster));
         }
 
         template <class TargetType>
         auto InternalDynamicCast(std::enable_if_t<!std::is_reference<TargetType>::value>*) const
         {
             auto caster = [](value_type t) -> TargetType { return dynamic_cast<TargetType>(t); };
-            return From(CreateSelectIterator(begin(), caster), CreateSelectIterator(end(), caster));
+            return From(CreateSelectIterator(This().begin(), caster), CreateSelectIterator(This().end(), caster));
         }
 
-        auto InternalReverse(std::bidirectional_iterator_tag) const { return From(std::make_reverse_iterator(end()), std::make_reverse_iterator(begin())); }
-        auto InternalReverse(std::input_iterator_tag) const { return CreateOwningEnumerable(begin(), end()).Reverse(); }
+        auto InternalReverse(std::bidirectional_iterator_tag) const { return From(std::make_reverse_iterator(This().end()), std::make_reverse_iterator(This().begin())); }
+        auto InternalReverse(std::input_iterator_tag) const { return CreateOwningEnumerable(This().begin(), This().end()).Reverse(); }
 
         template <class UnaryFunction>
-        auto InternalSelect(UnaryFunction unaryFunction, decltype(unaryFunction(*std::declval<IEnumerable>().begin()))*) const
+        auto InternalSelect(UnaryFunction unaryFunction, std::add_pointer_t<decltype(unaryFunction(*std::declval<InputIterator>()))>) const
         {
-            return From(CreateSelectIterator(begin(), unaryFunction), CreateSelectIterator(end(), unaryFunction));
+            return From(CreateSelectIterator(This().begin(), unaryFunction), CreateSelectIterator(This().end(), unaryFunction));
         }
 
         template <class UnaryFunctionWithIndex> 
-        auto InternalSelect(UnaryFunctionWithIndex unaryFunctionWithIndex, decltype(unaryFunctionWithIndex(*std::declval<IEnumerable>().begin(), 0))*) const
+        auto InternalSelect(UnaryFunctionWithIndex unaryFunctionWithIndex, std::add_pointer_t<decltype(unaryFunctionWithIndex(*std::declval<InputIterator>(), 0))>) const
         {
             return Zip(Enumerable::Range(0, std::numeric_limits<int64_t>::max()), unaryFunctionWithIndex);
         }
@@ -336,29 +578,58 @@ namespace Linqpp
         auto InternalStaticCast(std::enable_if_t<std::is_reference<TargetType>::value>*) const
         {
             auto caster = [](value_type& t) -> TargetType { return static_cast<TargetType>(t); };
-            return From(CreateSelectIterator(begin(), caster), CreateSelectIterator(end(), caster));
+            return From(CreateSelectIterator(This().begin(), caster), CreateSelectIterator(This().end(), caster));
         }
 
         template <class TargetType>
         auto InternalStaticCast(std::enable_if_t<!std::is_reference<TargetType>::value>*) const
         {
             auto caster = [](value_type t) -> TargetType { return static_cast<TargetType>(t); };
-            return From(CreateSelectIterator(begin(), caster), CreateSelectIterator(end(), caster));
+            return From(CreateSelectIterator(This().begin(), caster), CreateSelectIterator(This().end(), caster));
         }
 
         template <class Predicate> 
-        auto InternalWhere(Predicate predicate, decltype(predicate(*std::declval<IEnumerable>().begin()))*) const
+        auto InternalWhere(Predicate predicate, decltype(predicate(*std::declval<InputIterator>()))*) const
         {
-            auto first = CreateWhereIterator(begin(), end(), predicate);
-            auto last = CreateWhereIterator(end(), end(), predicate);
+            auto first = CreateWhereIterator(This().begin(), This().end(), predicate);
+            auto last = CreateWhereIterator(This().end(), This().end(), predicate);
             return From(first, last);
         }
 
         template <class PredicateWithIndex> 
-        auto InternalWhere(PredicateWithIndex predicateWithIndex, decltype(predicateWithIndex(*std::declval<IEnumerable>().begin(), 0))*) const
+        auto InternalWhere(PredicateWithIndex predicateWithIndex, decltype(predicateWithIndex(*std::declval<InputIterator>(), 0))*) const
         {
-            return Zip(Enumerable::Range(0, std::numeric_limits<int64_t>::max()), [](auto const& v, auto i) { return std::pair<decltype(v), decltype(i)>(v, i); })
+            auto indexer = [](auto&& v, auto i)
+            {
+                // Values produced on the fly must be kept, references into the source suffice otherwise.
+                using V = std::conditional_t<std::is_lvalue_reference<decltype(v)>::value, decltype(v), std::decay_t<decltype(v)>>;
+                return std::pair<V, decltype(i)>(std::forward<decltype(v)>(v), i);
+            };
+
+            return Zip(Enumerable::Range(0, std::numeric_limits<int64_t>::max()), indexer)
                 .Where([=](auto const& p) { return predicateWithIndex(p.first, p.second); }).Select([](auto const& p) { return p.first; });
         }
     };
+
+    // Type erasing boundary: holds a copy of any enumerable behind the virtual interface IEnumerable<InputIterator>.
+    template <class Source>
+    class ErasedEnumerable final : public IEnumerable<decltype(std::declval<Source const&>().begin())>
+    {
+        using Iterator = decltype(std::declval<Source const&>().begin());
+
+    private:
+        Source _enumerable;
+
+    public:
+        explicit ErasedEnumerable(Source enumerable) : _enumerable(std::move(enumerable)) { }
+
+        ErasedEnumerable(ErasedEnumerable const&) = default;
+        ErasedEnumerable(ErasedEnumerable&&) = default;
+        ErasedEnumerable& operator=(ErasedEnumerable const&) = default;
+        ErasedEnumerable& operator=(ErasedEnumerable&&) = default;
+
+    public:
+        virtual Iterator begin() const override { return _enumerable.begin(); }
+        virtual Iterator end() const override { return _enumerable.end(); }
+    };
 }
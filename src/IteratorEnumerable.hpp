@@ -5,7 +5,7 @@
 namespace Linqpp
 {
     template <class InputIterator>
-    class IteratorEnumerable : public IEnumerable<InputIterator>
+    class IteratorEnumerable : public IEnumerable<InputIterator, IteratorEnumerable<InputIterator>>
     {
     private:
         InputIterator _first;
@@ -21,7 +21,7 @@ namespace Linqpp
         IteratorEnumerable& operator=(IteratorEnumerable&&) = default;
 
     public:
-        virtual InputIterator begin() const override { return _first; }
-        virtual InputIterator end() const override { return _last; }
+        InputIterator begin() const { return _first; }
+        InputIterator end() const { return _last; }
     };
 }
@@ -1,62 +1,105 @@
 #pragma once
 
-#include <algorithm>
+#include "ForEach.hpp"
+#include "Reduction.hpp"
+
 #include <iterator>
+#include <stdexcept>
+#include <utility>
 
 namespace Linqpp
 {
     namespace Detail
     {
-        template <class ForwardIterator>
-        decltype(auto) InternalMax(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) { return *std::max_element(first, last); }
+        template <bool HasMin, bool HasMax, class InputIterator>
+        auto ReduceExtrema(InputIterator first, InputIterator last)
+        {
+            using T = std::decay_t<typename std::iterator_traits<InputIterator>::reference>;
+
+            auto extrema = Reduce(first, last, ExtremaReduction<T, HasMin, HasMax>());
+            if (extrema.IsEmpty())
+                throw std::invalid_argument("Sequence contains no matching element.");
 
-        template <class ForwardIterator>
-        decltype(auto) InternalMin(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) { return *std::min_element(first, last); }
+            return extrema;
+        }
 
         template <class InputIterator>
-        auto InternalMax(InputIterator first, InputIterator last, std::input_iterator_tag)
+        decltype(auto) InternalMax(InputIterator first, InputIterator last, std::false_type)
         {
-            if (first == last)
-                return *first;
-
-            auto maxValue = *first;
-            ++first;
-            for (;first != last; ++first)
+            IteratorElementHolder<InputIterator> maxValue;
+            ForEach(first, last, [&](auto&& value)
             {
-                auto temp = *first;
-                if (temp > maxValue)
-                    maxValue = std::move(temp);
-            }
-            return maxValue;
+                if (!maxValue.HasValue() || maxValue.Get() < value)
+                    maxValue.Set(std::forward<decltype(value)>(value));
+                return true;
+            });
+
+            return TakeElement(maxValue);
         }
 
         template <class InputIterator>
-        auto InternalMin(InputIterator first, InputIterator last, std::input_iterator_tag)
+        auto InternalMax(InputIterator first, InputIterator last, std::true_type) { return ReduceExtrema<false, true>(first, last).Max(); }
+
+        template <class InputIterator>
+        decltype(auto) InternalMin(InputIterator first, InputIterator last, std::false_type)
         {
-            if (first == last)
-                return *first;
+            IteratorElementHolder<InputIterator> minValue;
+            ForEach(first, last, [&](auto&& value)
+            {
+                if (!minValue.HasValue() || value < minValue.Get())
+                    minValue.Set(std::forward<decltype(value)>(value));
+                return true;
+            });
+
+            return TakeElement(minValue);
+        }
+
+        template <class InputIterator>
+        auto InternalMin(InputIterator first, InputIterator last, std::true_type) { return ReduceExtrema<true, false>(first, last).Min(); }
 
-            auto minValue = *first;
-            ++first;
-            for (;first != last; ++first)
+        template <class InputIterator>
+        auto InternalMinMax(InputIterator first, InputIterator last, std::false_type)
+        {
+            // Elements are not forwarded, as a single one may become both minimum and maximum.
+            IteratorElementHolder<InputIterator> minValue, maxValue;
+            ForEach(first, last, [&](auto&& value)
             {
-                auto temp = *first;
-                if (temp < minValue)
-                    minValue = std::move(temp);
-            }
-            return minValue;
+                if (!minValue.HasValue() || value < minValue.Get())
+                    minValue.Set(value);
+                if (!maxValue.HasValue() || maxValue.Get() < value)
+                    maxValue.Set(value);
+                return true;
+            });
+
+            using Result = decltype(TakeElement(minValue));
+            return std::pair<Result, Result>(TakeElement(minValue), TakeElement(maxValue));
+        }
+
+        template <class InputIterator>
+        auto InternalMinMax(InputIterator first, InputIterator last, std::true_type)
+        {
+            auto extrema = ReduceExtrema<true, true>(first, last);
+            return std::make_pair(extrema.Min(), extrema.Max());
         }
     }
 
+    // Arithmetic elements are returned by value and reduced with vectorized kernels.
     template <class InputIterator>
     decltype(auto) Max(InputIterator first, InputIterator last)
     {
-        return Detail::InternalMax(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+        return Detail::InternalMax(first, last, Detail::IsBlockElement<typename std::iterator_traits<InputIterator>::reference>());
     }
 
     template <class InputIterator>
     decltype(auto) Min(InputIterator first, InputIterator last)
     {
-        return Detail::InternalMin(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+        return Detail::InternalMin(first, last, Detail::IsBlockElement<typename std::iterator_traits<InputIterator>::reference>());
+    }
+
+    // Returns the pair (minimum, maximum) in a single pass.
+    template <class InputIterator>
+    auto MinMax(InputIterator first, InputIterator last)
+    {
+        return Detail::InternalMinMax(first, last, Detail::IsBlockElement<typename std::iterator_traits<InputIterator>::reference>());
     }
 }
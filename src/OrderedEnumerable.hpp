@@ -0,0 +1,82 @@
+#pragma once
+
+#include "iterator/SortingIterator.hpp"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace Linqpp
+{
+    template <class InputIterator, class Derived>
+    class IEnumerable;
+
+    // The result of OrderBy, which ThenBy and ThenByDescending refine by further keys. Each of them sorts the source
+    // again in a single pass by the keys of all levels, computed once per element and compared level by level
+    // only as long as they are equivalent.
+    template <class InputIterator, class KeySelector, class KeyComparer>
+    class OrderedEnumerable : public IEnumerable<SortingIterator<InputIterator, KeySelector, KeyComparer>, OrderedEnumerable<InputIterator, KeySelector, KeyComparer>>
+    {
+    private:
+        using Iterator = SortingIterator<InputIterator, KeySelector, KeyComparer>;
+
+        static_assert(std::is_copy_assignable<Iterator>::value, "SortingIterator is not copy assignable.");
+
+    private:
+        Iterator _first;
+        Iterator _last;
+
+    public:
+        OrderedEnumerable(InputIterator first, InputIterator last, KeySelector keySelector, KeyComparer keyComparer)
+            : _first(first, last, keySelector, keyComparer), _last(_first.GetEnd())
+        { }
+
+        OrderedEnumerable() = default;
+        OrderedEnumerable(OrderedEnumerable const&) = default;
+        OrderedEnumerable(OrderedEnumerable&&) = default;
+        OrderedEnumerable& operator=(OrderedEnumerable const&) = default;
+        OrderedEnumerable& operator=(OrderedEnumerable&&) = default;
+
+    public:
+        Iterator begin() const { return _first; }
+        Iterator end() const { return _last; }
+
+    public:
+        template <class UnaryFunction>
+        auto ThenBy(UnaryFunction unaryFunction) const { return ThenBy(unaryFunction, std::less<>()); }
+
+        template <class UnaryFunction, class LessThanComparer>
+        auto ThenBy(UnaryFunction unaryFunction, LessThanComparer comparer) const
+        {
+            auto keySelector = _first.GetKeySelector();
+            auto keyComparer = _first.GetKeyComparer();
+
+            auto thenKeySelector = [=] (auto const& t) { return std::make_pair(keySelector(t), unaryFunction(t)); };
+            auto thenKeyComparer = [=] (auto const& keys1, auto const& keys2)
+            {
+                if (keyComparer(keys1.first, keys2.first))
+                    return true;
+                if (keyComparer(keys2.first, keys1.first))
+                    return false;
+                return static_cast<bool>(comparer(keys1.second, keys2.second));
+            };
+
+            return CreateSortedEnumerable(_first.GetFirst(), _first.GetLast(), thenKeySelector, thenKeyComparer);
+        }
+
+        template <class UnaryFunction>
+        auto ThenByDescending(UnaryFunction unaryFunction) const { return ThenBy(unaryFunction, std::greater<>()); }
+
+        template <class UnaryFunction, class LessThanComparer>
+        auto ThenByDescending(UnaryFunction unaryFunction, LessThanComparer comparer) const
+        {
+            return ThenBy(unaryFunction, [=] (auto const& t1, auto const& t2) { return comparer(t2, t1); });
+        }
+    };
+
+    template <class InputIterator, class KeySelector, class KeyComparer>
+    auto CreateSortedEnumerable(InputIterator first, InputIterator last, KeySelector keySelector, KeyComparer keyComparer)
+    {
+        return OrderedEnumerable<InputIterator, KeySelector, KeyComparer>(first, last, keySelector, keyComparer);
+    }
+}
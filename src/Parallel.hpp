@@ -0,0 +1,168 @@
+#pragma once
+
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        // Calls function(i) for all i in [0, count) on the calling thread and on up to Concurrency() - 1 workers of the pool,
+        // which take the next i whenever they are done with one. Returns when all calls are done and rethrows the first
+        // exception that any of them threw.
+        template <class Function>
+        void ParallelFor(size_t count, Function const& function)
+        {
+            auto& pool = Yielding::WorkerPool::Instance();
+            auto threads = std::min(pool.Concurrency(), count);
+            if (threads <= 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    function(i);
+
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::exception_ptr spException;
+            size_t runningWorkers = 0;
+
+            auto work = [&]
+            {
+                try
+                {
+                    for (auto i = next++; i < count; i = next++)
+                        function(i);
+                }
+                catch (...)
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!spException)
+                        spException = std::current_exception();
+
+                    next = count;
+                }
+            };
+
+            for (size_t thread = 1; thread < threads; ++thread)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ++runningWorkers;
+                }
+
+                try
+                {
+                    // Notifies while holding the lock, so that nothing here is destroyed before the worker is done with it.
+                    pool.Run([&]
+                    {
+                        work();
+                        std::unique_lock<std::mutex> lock(mutex);
+                        if (--runningWorkers == 0)
+                            cv.notify_one();
+                    });
+                }
+                catch (...)
+                {
+                    // No more workers, the calling thread does the rest.
+                    std::unique_lock<std::mutex> lock(mutex);
+                    --runningWorkers;
+                    break;
+                }
+            }
+
+            work();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return runningWorkers == 0; });
+
+            if (spException)
+                std::rethrow_exception(spException);
+        }
+
+        // From this size on, sorting a segment completely runs in parallel if the pool's concurrency allows it.
+        constexpr size_t ParallelSortThreshold = size_t(1) << 16;
+
+        // Sorts [first, last) of data on the given number of threads: each sorts a chunk, then pairs of sorted runs are
+        // merged until one is left. Merges are split into pieces that are merged in parallel as well, so that all threads
+        // keep working when there are few runs left. comparer must order all elements totally, then the result is that
+        // of std::sort. Runs are merged back and forth between the range and a buffer of its size.
+        template <class T, class LessThanComparer>
+        void ParallelMergeSort(std::vector<T>& data, size_t first, size_t last, LessThanComparer const& comparer, size_t threads)
+        {
+            auto size = last - first;
+            std::vector<size_t> runs(threads + 1);
+            for (size_t run = 0; run <= threads; ++run)
+                runs[run] = size * run / threads;
+
+            auto input = data.begin() + first;
+            ParallelFor(threads, [&](size_t run) { std::sort(input + runs[run], input + runs[run + 1], comparer); });
+
+            std::vector<T> buffer(input, input + size);
+            auto output = buffer.begin();
+            while (runs.size() > 2)
+            {
+                auto merges = runs.size() / 2;
+                auto pieces = std::max<size_t>(1, threads / merges);
+
+                auto runOf = [&](size_t merge)
+                {
+                    auto first1 = runs[2 * merge];
+                    auto last1 = runs[2 * merge + 1];
+                    auto last2 = 2 * merge + 2 < runs.size() ? runs[2 * merge + 2] : last1;
+                    return std::make_tuple(first1, last1, last2);
+                };
+
+                // Each piece merges a part of the first run with the elements of the second run that go before the
+                // next part, so the second run is split first, before any elements are moved.
+                std::vector<size_t> splits(merges * pieces);
+                ParallelFor(merges * pieces, [&](size_t task)
+                {
+                    size_t first1, last1, last2;
+                    std::tie(first1, last1, last2) = runOf(task / pieces);
+
+                    auto position = first1 + (last1 - first1) * (task % pieces) / pieces;
+                    splits[task] = task % pieces == 0 ? last1 : position == last1 ? last2
+                        : static_cast<size_t>(std::lower_bound(input + last1, input + last2, input[position], comparer) - input);
+                });
+
+                ParallelFor(merges * pieces, [&](size_t task)
+                {
+                    size_t first1, last1, last2;
+                    std::tie(first1, last1, last2) = runOf(task / pieces);
+
+                    auto piece = task % pieces;
+                    auto begin1 = first1 + (last1 - first1) * piece / pieces;
+                    auto end1 = first1 + (last1 - first1) * (piece + 1) / pieces;
+                    auto begin2 = splits[task];
+                    auto end2 = piece + 1 == pieces ? last2 : splits[task + 1];
+
+                    std::merge(std::make_move_iterator(input + begin1), std::make_move_iterator(input + end1),
+                            std::make_move_iterator(input + begin2), std::make_move_iterator(input + end2),
+                            output + begin1 + (begin2 - last1), comparer);
+                });
+
+                std::vector<size_t> mergedRuns;
+                for (size_t run = 0; run + 1 < runs.size(); run += 2)
+                    mergedRuns.push_back(runs[run]);
+                mergedRuns.push_back(size);
+
+                runs.swap(mergedRuns);
+                std::swap(input, output);
+            }
+
+            if (input != data.begin() + first)
+                std::move(input, input + size, data.begin() + first);
+        }
+    }
+}
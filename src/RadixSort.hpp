@@ -0,0 +1,272 @@
+#pragma once
+
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        template <size_t Size> struct UnsignedOfSize;
+        template <> struct UnsignedOfSize<1> { using type = std::uint8_t; };
+        template <> struct UnsignedOfSize<2> { using type = std::uint16_t; };
+        template <> struct UnsignedOfSize<4> { using type = std::uint32_t; };
+        template <> struct UnsignedOfSize<8> { using type = std::uint64_t; };
+
+        // Keys whose order is that of unsigned integers they map to, so that they can be sorted by their bits.
+        // Enums are not among them, as they may come with an operator< or a std::less of their own.
+        template <class Key>
+        using IsRadixKey = std::integral_constant<bool, (std::is_integral<Key>::value
+                || (std::is_floating_point<Key>::value && std::numeric_limits<Key>::is_iec559)) && sizeof(Key) <= 8>;
+
+        template <class Key>
+        using RadixBits = typename UnsignedOfSize<sizeof(Key)>::type;
+
+        template <class Key>
+        constexpr RadixBits<Key> SignBit() { return static_cast<RadixBits<Key>>(RadixBits<Key>(1) << (8 * sizeof(Key) - 1)); }
+
+        // Flipping the sign bit of signed integers orders negative ones before the others.
+        template <class Key>
+        auto ToRadixBits(Key key) -> std::enable_if_t<std::is_integral<Key>::value, RadixBits<Key>>
+        {
+            auto bits = static_cast<RadixBits<Key>>(key);
+            return std::is_signed<Key>::value ? static_cast<RadixBits<Key>>(bits ^ SignBit<Key>()) : bits;
+        }
+
+        // The bits of negative floating point numbers are in reverse order, so they are flipped entirely,
+        // while the others only get the sign bit. -0 becomes 0, as both are equivalent.
+        template <class Key>
+        auto ToRadixBits(Key key) -> std::enable_if_t<std::is_floating_point<Key>::value, RadixBits<Key>>
+        {
+            if (key == 0)
+                key = 0;
+
+            RadixBits<Key> bits;
+            std::memcpy(&bits, &key, sizeof(key));
+            return (bits & SignBit<Key>()) != 0 ? static_cast<RadixBits<Key>>(~bits) : static_cast<RadixBits<Key>>(bits | SignBit<Key>());
+        }
+
+        // Below this size, std::stable_sort is faster than going through the counts of all digits.
+        constexpr size_t RadixSortThreshold = 256;
+
+        // Keys that span at most this many values, and not more than there are elements, are sorted by a single counting pass.
+        constexpr size_t CountingSortRange = size_t(1) << 16;
+
+        // Sorts the non-empty range [first, last) stably by bucketOf, which maps elements to [0, buckets).
+        // Returns where each bucket begins, followed by the number of elements.
+        // The range is split into chunks that are counted and moved in parallel.
+        template <class Iterator, class BucketOf>
+        std::vector<size_t> CountingSort(Iterator first, Iterator last, BucketOf const& bucketOf, size_t buckets, size_t chunks = 1)
+        {
+            auto size = static_cast<size_t>(last - first);
+            auto forEachInChunk = [&](size_t chunk, auto const& function)
+            {
+                for (auto i = size * chunk / chunks; i < size * (chunk + 1) / chunks; ++i)
+                    function(i);
+            };
+
+            std::vector<size_t> offsets(chunks * buckets);
+            ParallelFor(chunks, [&](size_t chunk)
+            {
+                auto counts = offsets.begin() + chunk * buckets;
+                forEachInChunk(chunk, [&](size_t i) { ++counts[bucketOf(first[i])]; });
+            });
+
+            // Within a bucket, the elements of earlier chunks go first, which keeps the sort stable.
+            std::vector<size_t> bounds(buckets + 1);
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < buckets; ++bucket)
+            {
+                bounds[bucket] = offset;
+                for (size_t chunk = 0; chunk < chunks; ++chunk)
+                    offset += std::exchange(offsets[chunk * buckets + bucket], offset);
+            }
+
+            bounds[buckets] = size;
+
+            auto bucket = bucketOf(*first);
+            if (bounds[bucket + 1] - bounds[bucket] == size)
+                return bounds;
+
+            std::vector<typename std::iterator_traits<Iterator>::value_type> buffer(first, last);
+            ParallelFor(chunks, [&](size_t chunk)
+            {
+                auto targets = offsets.begin() + chunk * buckets;
+                forEachInChunk(chunk, [&](size_t i) { first[targets[bucketOf(buffer[i])]++] = std::move(buffer[i]); });
+            });
+
+            return bounds;
+        }
+
+        // Sorts [first, last) stably by the lowest digits bytes of the radix keys that bitsOf returns, one pass per byte.
+        // Bytes that all keys share are skipped.
+        template <class Iterator, class BitsOf>
+        void LsdRadixSort(Iterator first, Iterator last, BitsOf const& bitsOf, size_t digits)
+        {
+            auto size = static_cast<size_t>(last - first);
+            if (size < RadixSortThreshold)
+            {
+                std::stable_sort(first, last, [&](auto const& value1, auto const& value2) { return bitsOf(value1) < bitsOf(value2); });
+                return;
+            }
+
+            std::vector<size_t> counts(digits * 256);
+            for (auto it = first; it != last; ++it)
+            {
+                auto bits = bitsOf(*it);
+                for (size_t digit = 0; digit < digits; ++digit)
+                    ++counts[digit * 256 + ((bits >> (8 * digit)) & 255)];
+            }
+
+            std::vector<typename std::iterator_traits<Iterator>::value_type> buffer(first, last);
+            bool isInBuffer = false;
+
+            for (size_t digit = 0; digit < digits; ++digit)
+            {
+                auto digitOf = [&](auto const& value) { return (bitsOf(value) >> (8 * digit)) & 255; };
+                auto offsets = counts.begin() + digit * 256;
+                if (offsets[digitOf(*first)] == size)
+                    continue;
+
+                size_t offset = 0;
+                for (size_t i = 0; i < 256; ++i)
+                    offset += std::exchange(offsets[i], offset);
+
+                auto scatter = [&](auto from, auto to, auto target)
+                {
+                    for (; from != to; ++from)
+                        target[offsets[digitOf(*from)]++] = std::move(*from);
+                };
+
+                if (isInBuffer)
+                    scatter(buffer.begin(), buffer.end(), first);
+                else
+                    scatter(first, last, buffer.begin());
+
+                isInBuffer = !isInBuffer;
+            }
+
+            if (isInBuffer)
+                std::move(buffer.begin(), buffer.end(), first);
+        }
+
+        // Data split into segments that hold exactly the elements that belong there, and how to sort a segment.
+        // Without sort, nothing is known about the order. IncrementalSort calls sort under its lock only, but may
+        // sort several segments in parallel.
+        template <class Vector>
+        struct SortedSegments
+        {
+            std::vector<size_t> bounds;
+            std::function<void(Vector&, size_t, size_t)> sort;
+
+            // Data that is sorted completely.
+            static SortedSegments Sorted() { return { { }, [](Vector&, size_t, size_t) { } }; }
+        };
+
+        // Sorts pairs stably by their radix keys, the first elements, lazily: a counting pass by the top byte of their
+        // distances to the smallest key splits them into segments that are sorted by the other bytes when accessed.
+        // Keys that span a small range are sorted completely. The passes over large inputs run in parallel.
+        template <class Pair>
+        SortedSegments<std::vector<Pair>> RadixSplit(std::vector<Pair>& pairs, bool isDescending)
+        {
+            using Bits = RadixBits<typename Pair::first_type>;
+
+            auto segments = SortedSegments<std::vector<Pair>>::Sorted();
+
+            if (pairs.empty())
+                return segments;
+
+            auto toBits = [isDescending](Pair const& pair)
+            {
+                auto bits = ToRadixBits(pair.first);
+                return isDescending ? static_cast<Bits>(~bits) : bits;
+            };
+
+            auto chunks = pairs.size() >= ParallelSortThreshold ? Yielding::WorkerPool::Instance().Concurrency() : 1;
+
+            std::vector<std::pair<Bits, Bits>> minMaxes(chunks, std::make_pair(toBits(pairs.front()), toBits(pairs.front())));
+            ParallelFor(chunks, [&](size_t chunk)
+            {
+                auto& minMax = minMaxes[chunk];
+                for (auto i = pairs.size() * chunk / chunks; i < pairs.size() * (chunk + 1) / chunks; ++i)
+                {
+                    auto bits = toBits(pairs[i]);
+                    minMax.first = std::min(minMax.first, bits);
+                    minMax.second = std::max(minMax.second, bits);
+                }
+            });
+
+            auto min = minMaxes.front().first;
+            auto max = minMaxes.front().second;
+            for (auto const& minMax : minMaxes)
+            {
+                min = std::min(min, minMax.first);
+                max = std::max(max, minMax.second);
+            }
+
+            auto bitsOf = [toBits, min](Pair const& pair) { return static_cast<Bits>(toBits(pair) - min); };
+            auto range = static_cast<size_t>(static_cast<Bits>(max - min));
+
+            if (pairs.size() < RadixSortThreshold)
+                std::stable_sort(pairs.begin(), pairs.end(), [&](Pair const& pair1, Pair const& pair2) { return bitsOf(pair1) < bitsOf(pair2); });
+            else if (range < CountingSortRange && range <= pairs.size())
+                CountingSort(pairs.begin(), pairs.end(), bitsOf, range + 1, chunks);
+            else
+            {
+                size_t digits = 0;
+                for (auto rest = range; rest != 0; rest >>= 8)
+                    ++digits;
+
+                auto shift = 8 * (digits - 1);
+                segments.bounds = CountingSort(pairs.begin(), pairs.end(), [&](Pair const& pair) { return bitsOf(pair) >> shift; }, 256, chunks);
+                segments.sort = [bitsOf, digits](std::vector<Pair>& pairs, size_t first, size_t last)
+                {
+                    LsdRadixSort(pairs.begin() + first, pairs.begin() + last, bitsOf, digits - 1);
+                };
+            }
+
+            return segments;
+        }
+
+        template <class Key, class T>
+        using IsRadixComparer = std::integral_constant<bool, IsRadixKey<Key>::value && (std::is_void<T>::value || std::is_same<T, Key>::value)>;
+
+        // Radix sorts pairs whose keys, the first elements, are radix keys compared by std::less or std::greater.
+        template <class Pair, class T>
+        auto TryRadixSplit(std::vector<Pair>& pairs, std::less<T> const&)
+            -> std::enable_if_t<IsRadixComparer<typename Pair::first_type, T>::value, SortedSegments<std::vector<Pair>>>
+        {
+            return RadixSplit(pairs, false);
+        }
+
+        template <class Pair, class T>
+        auto TryRadixSplit(std::vector<Pair>& pairs, std::greater<T> const&)
+            -> std::enable_if_t<IsRadixComparer<typename Pair::first_type, T>::value, SortedSegments<std::vector<Pair>>>
+        {
+            return RadixSplit(pairs, true);
+        }
+
+        template <class Pair, class KeyComparer>
+        SortedSegments<std::vector<Pair>> TryRadixSplit(std::vector<Pair>&, KeyComparer const&) { return { }; }
+
+        // Whether keys compared by KeyComparer are radix sorted by TryRadixSplit.
+        template <class Key, class KeyComparer>
+        struct IsRadixSorted : std::false_type { };
+
+        template <class Key, class T>
+        struct IsRadixSorted<Key, std::less<T>> : IsRadixComparer<Key, T> { };
+
+        template <class Key, class T>
+        struct IsRadixSorted<Key, std::greater<T>> : IsRadixComparer<Key, T> { };
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <iterator>
+#include <memory>
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Type erased range that a yielding function delegates to its caller via yield_from.
+        template <class T>
+        class RangeCursor
+        {
+        public:
+            virtual ~RangeCursor() = default;
+
+        public:
+            virtual bool IsAtEnd() const = 0;
+            virtual T Get() const = 0;
+            virtual void Increment() = 0;
+        };
+
+        template <class T, class InputIterator>
+        class IteratorRangeCursor : public RangeCursor<T>
+        {
+        private:
+            InputIterator _current;
+            InputIterator _last;
+
+        public:
+            IteratorRangeCursor(InputIterator first, InputIterator last) : _current(first), _last(last) { }
+
+        public:
+            virtual bool IsAtEnd() const override { return _current == _last; }
+            virtual T Get() const override { return *_current; }
+            virtual void Increment() override { ++_current; }
+        };
+
+        template <class T, class Container>
+        std::unique_ptr<RangeCursor<T>> CreateRangeCursor(Container&& container)
+        {
+            auto first = std::begin(std::forward<Container>(container));
+            auto last = std::end(std::forward<Container>(container));
+            return std::make_unique<IteratorRangeCursor<T, decltype(first)>>(first, last);
+        }
+    }
+}
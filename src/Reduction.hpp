@@ -0,0 +1,220 @@
+#pragma once
+
+#include "ForEach.hpp"
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        // Integers are summed in 64 bits, so partial sums of smaller types do not overflow.
+        template <class T>
+        using SumType = std::conditional_t<std::is_floating_point<T>::value, T, std::conditional_t<std::is_signed<T>::value, std::int64_t, std::uint64_t>>;
+
+        // The reductions below keep Lanes independent partial results, two 256 bit registers worth,
+        // so the compiler turns their inner loops into vector instructions.
+        // Partial results are copied to locals while running, as the input might alias members of the same type.
+        template <class T>
+        class SumReduction
+        {
+        public:
+            using Sum = SumType<T>;
+
+        private:
+            static constexpr size_t Lanes = 64 / sizeof(Sum);
+
+        private:
+            Sum _partial[Lanes] = {};
+            bool _isEmpty = true;
+
+        public:
+            template <class U>
+            void Add(U const* values, size_t count)
+            {
+                Sum partial[Lanes];
+                std::copy(_partial, _partial + Lanes, partial);
+
+                size_t i = 0;
+                for (; i + Lanes <= count; i += Lanes)
+                {
+                    for (size_t j = 0; j < Lanes; ++j)
+                        partial[j] += values[i + j];
+                }
+
+                for (size_t j = 0; i < count; ++i, ++j)
+                    partial[j] += values[i];
+
+                std::copy(partial, partial + Lanes, _partial);
+                _isEmpty = _isEmpty && count == 0;
+            }
+
+            // Adds the products multiply(values1[i], values2[i]).
+            template <class U, class V, class Multiply>
+            void AddProducts(U const* values1, V const* values2, size_t count, Multiply const& multiply)
+            {
+                Sum partial[Lanes];
+                std::copy(_partial, _partial + Lanes, partial);
+
+                size_t i = 0;
+                for (; i + Lanes <= count; i += Lanes)
+                {
+                    for (size_t j = 0; j < Lanes; ++j)
+                        partial[j] += multiply(values1[i + j], values2[i + j]);
+                }
+
+                for (size_t j = 0; i < count; ++i, ++j)
+                    partial[j] += multiply(values1[i], values2[i]);
+
+                std::copy(partial, partial + Lanes, _partial);
+                _isEmpty = _isEmpty && count == 0;
+            }
+
+            bool IsEmpty() const { return _isEmpty; }
+
+            Sum Result() const
+            {
+                Sum sum = 0;
+                for (size_t j = 0; j < Lanes; ++j)
+                    sum += _partial[j];
+
+                return sum;
+            }
+        };
+
+        // Minimum and/or maximum in a single pass.
+        template <class T, bool HasMin, bool HasMax>
+        class ExtremaReduction
+        {
+        private:
+            static constexpr size_t Lanes = 64 / sizeof(T);
+
+        private:
+            T _min[Lanes];
+            T _max[Lanes];
+            bool _isEmpty = true;
+
+        public:
+            template <class U>
+            void Add(U const* values, size_t count)
+            {
+                if (count == 0)
+                    return;
+
+                if (_isEmpty)
+                {
+                    std::fill(_min, _min + Lanes, static_cast<T>(values[0]));
+                    std::fill(_max, _max + Lanes, static_cast<T>(values[0]));
+                    _isEmpty = false;
+                }
+
+                T min[Lanes], max[Lanes];
+                std::copy(_min, _min + Lanes, min);
+                std::copy(_max, _max + Lanes, max);
+
+                size_t i = 0;
+                for (; i + Lanes <= count; i += Lanes)
+                {
+                    for (size_t j = 0; j < Lanes; ++j)
+                        Update(min[j], max[j], values[i + j]);
+                }
+
+                for (size_t j = 0; i < count; ++i, ++j)
+                    Update(min[j], max[j], values[i]);
+
+                std::copy(min, min + Lanes, _min);
+                std::copy(max, max + Lanes, _max);
+            }
+
+            bool IsEmpty() const { return _isEmpty; }
+
+            T Min() const
+            {
+                T min = _min[0];
+                for (size_t j = 1; j < Lanes; ++j)
+                    min = _min[j] < min ? _min[j] : min;
+
+                return min;
+            }
+
+            T Max() const
+            {
+                T max = _max[0];
+                for (size_t j = 1; j < Lanes; ++j)
+                    max = max < _max[j] ? _max[j] : max;
+
+                return max;
+            }
+
+        private:
+            template <class U>
+            static void Update(T& min, T& max, U const& value)
+            {
+                if (HasMin)
+                    min = value < min ? static_cast<T>(value) : min;
+                if (HasMax)
+                    max = max < value ? static_cast<T>(value) : max;
+            }
+        };
+
+        // Counts branch-free, which vectorizes for simple predicates such as comparisons.
+        template <class Predicate>
+        class CountReduction
+        {
+        private:
+            Predicate& _predicate;
+            size_t _count = 0;
+
+        public:
+            explicit CountReduction(Predicate& predicate) : _predicate(predicate) { }
+
+        public:
+            template <class U>
+            void Add(U const* values, size_t count)
+            {
+                size_t matches = 0;
+                for (size_t i = 0; i < count; ++i)
+                    matches += static_cast<bool>(_predicate(values[i]));
+
+                _count += matches;
+            }
+
+            size_t Result() const { return _count; }
+        };
+
+        template <class Reduction, class U>
+        void AddToReduction(Reduction& reduction, U const* values, size_t count)
+        {
+            RunKernel([&] { reduction.Add(values, count); });
+        }
+
+        template <class Iterator, class Reduction>
+        void InternalReduce(Iterator const& first, Iterator const& last, Reduction& reduction, std::true_type)
+        {
+            if (first != last)
+                AddToReduction(reduction, std::addressof(*first), static_cast<size_t>(last - first));
+        }
+
+        template <class Iterator, class Reduction>
+        void InternalReduce(Iterator const& first, Iterator const& last, Reduction& reduction, std::false_type)
+        {
+            Linqpp::ForEachBlock(first, last, [&](auto const* values, size_t count)
+            {
+                AddToReduction(reduction, values, count);
+                return true;
+            });
+        }
+
+        // Runs a reduction over arithmetic elements: contiguous sources in a single call, others block by block.
+        template <class Iterator, class Reduction>
+        Reduction Reduce(Iterator const& first, Iterator const& last, Reduction reduction)
+        {
+            InternalReduce(first, last, reduction, IsContiguous<Iterator>());
+            return reduction;
+        }
+    }
+}
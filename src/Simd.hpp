@@ -0,0 +1,163 @@
+#pragma once
+
+#include "ForEach.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(LINQPP_NO_SIMD_DISPATCH)
+#define LINQPP_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+#ifdef LINQPP_AVX2_DISPATCH
+        inline bool HasAvx2()
+        {
+            static bool const hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+            return hasAvx2;
+        }
+
+        template <class Kernel>
+        __attribute__((target("avx2"), flatten)) void RunKernelAvx2(Kernel& kernel) { kernel(); }
+#endif
+
+        // Runs kernel, compiled for AVX2 if the CPU supports it. flatten inlines all that kernel calls, e.g. predicates,
+        // so loops in there are vectorized for AVX2 as well.
+        template <class Kernel>
+        void RunKernel(Kernel kernel)
+        {
+#ifdef LINQPP_AVX2_DISPATCH
+            if (HasAvx2())
+                return RunKernelAvx2(kernel);
+#endif
+            kernel();
+        }
+
+        // Writes the elements of values that fit predicate to output, which must not overlap values,
+        // and returns their number. Every element is written, but only fits advance the output.
+        template <class T, class Predicate>
+        size_t Compress(T const* values, size_t count, Predicate& predicate, T* output)
+        {
+            size_t fits = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                output[fits] = values[i];
+                fits += static_cast<bool>(predicate(values[i]));
+            }
+
+            return fits;
+        }
+
+#ifdef LINQPP_AVX2_DISPATCH
+        // Permutations of 32 bit lanes that move the lanes selected by a mask to the front, for masks of 8 lanes of
+        // 4 bytes (Lanes = 8) or 4 lanes of 8 bytes (Lanes = 4).
+        template <size_t Lanes>
+        struct CompressTable
+        {
+            alignas(32) std::int32_t permutations[1 << Lanes][8];
+
+            CompressTable()
+            {
+                constexpr size_t Words = 8 / Lanes;
+
+                for (size_t mask = 0; mask < (1 << Lanes); ++mask)
+                {
+                    size_t next = 0;
+                    for (size_t lane = 0; lane < Lanes; ++lane)
+                    {
+                        if (mask & (1 << lane))
+                        {
+                            for (size_t word = 0; word < Words; ++word)
+                                permutations[mask][next++] = static_cast<std::int32_t>(lane * Words + word);
+                        }
+                    }
+
+                    while (next < 8)
+                        permutations[mask][next++] = 0;
+                }
+            }
+
+            static CompressTable const& Instance()
+            {
+                static CompressTable const table;
+                return table;
+            }
+        };
+
+        // Moves the selected elements of values to output. selected holds 0 or 1 per element.
+        // Each store writes a whole register, but never beyond the elements read so far. Expects count <= BlockSize.
+        template <class T>
+        __attribute__((target("avx2,popcnt"))) size_t CompressSelectedAvx2(T const* values, unsigned char const* selected, size_t count, T* output)
+        {
+            constexpr size_t Lanes = 32 / sizeof(T);
+            auto const& table = CompressTable<Lanes>::Instance();
+
+            auto vectorized = count / 32 * 32;
+            size_t fits = 0, i = 0;
+            for (; i < vectorized; i += 32)
+            {
+                // Moves bit 0 of each byte to bit 7, where movemask reads it.
+                auto bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(selected + i));
+                auto masks = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(bytes, 7)));
+
+                for (size_t group = 0; group < 32; group += Lanes, masks >>= Lanes)
+                {
+                    auto mask = masks & ((1u << Lanes) - 1);
+                    auto data = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(values + i + group));
+                    auto permutation = _mm256_load_si256(reinterpret_cast<__m256i const*>(table.permutations[mask]));
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + fits), _mm256_permutevar8x32_epi32(data, permutation));
+                    fits += __builtin_popcount(mask);
+                }
+            }
+
+            for (size_t j = 0; j < count % 32; ++j)
+            {
+                output[fits] = values[i + j];
+                fits += selected[i + j];
+            }
+
+            return fits;
+        }
+
+        // Evaluates the predicate on all elements first, which vectorizes for simple predicates, then compresses.
+        // Expects count <= BlockSize.
+        template <class T, class Predicate>
+        __attribute__((target("avx2,popcnt"), flatten)) size_t CompressAvx2(T const* values, size_t count, Predicate& predicate, T* output)
+        {
+            unsigned char selected[BlockSize];
+            for (size_t i = 0; i < count; ++i)
+                selected[i] = static_cast<bool>(predicate(values[i]));
+
+            return CompressSelectedAvx2(values, selected, count, output);
+        }
+#endif
+
+        template <class T, class Predicate>
+        size_t InternalCompressBlock(T const* values, size_t count, Predicate& predicate, T* output, std::true_type)
+        {
+#ifdef LINQPP_AVX2_DISPATCH
+            if (HasAvx2())
+                return CompressAvx2(values, count, predicate, output);
+#endif
+            return Compress(values, count, predicate, output);
+        }
+
+        template <class T, class Predicate>
+        size_t InternalCompressBlock(T const* values, size_t count, Predicate& predicate, T* output, std::false_type)
+        {
+            return Compress(values, count, predicate, output);
+        }
+
+        // Compress for blocks of at most BlockSize elements, vectorized with AVX2 for elements of 4 or 8 bytes.
+        template <class T, class Predicate>
+        size_t CompressBlock(T const* values, size_t count, Predicate& predicate, T* output)
+        {
+            return InternalCompressBlock(values, count, predicate, output, std::integral_constant<bool, sizeof(T) == 4 || sizeof(T) == 8>());
+        }
+    }
+}
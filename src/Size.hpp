@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace Linqpp
+{
+    namespace Detail
+    {
+        // What is known about the number of elements of a range without iterating it:
+        // the exact size, an upper bound, or neither.
+        class SizeBound
+        {
+        public:
+            static constexpr size_t Unknown = std::numeric_limits<size_t>::max();
+
+        private:
+            size_t _size = Unknown;
+            size_t _maxSize = Unknown;
+
+        private:
+            SizeBound(size_t size, size_t maxSize) : _size(size), _maxSize(maxSize) { }
+
+        public:
+            SizeBound() = default;
+
+            static SizeBound Exactly(size_t size) { return SizeBound(size, size); }
+            static SizeBound AtMost(size_t maxSize) { return SizeBound(Unknown, maxSize); }
+
+        public:
+            bool IsExact() const { return _size != Unknown; }
+            size_t Size() const { return _size; }
+            size_t MaxSize() const { return _maxSize; }
+
+            // Bound of a subsequence such as the result of Where.
+            SizeBound Filtered() const { return AtMost(_maxSize); }
+
+            SizeBound Take(size_t n) const { return SizeBound(IsExact() ? std::min(_size, n) : Unknown, std::min(_maxSize, n)); }
+
+            SizeBound Skip(size_t n) const
+            {
+                return SizeBound(IsExact() ? _size - std::min(_size, n) : Unknown, _maxSize != Unknown ? _maxSize - std::min(_maxSize, n) : Unknown);
+            }
+
+            friend SizeBound operator+(SizeBound const& bound1, SizeBound const& bound2)
+            {
+                return SizeBound(Add(bound1._size, bound2._size), Add(bound1._maxSize, bound2._maxSize));
+            }
+
+            friend SizeBound Min(SizeBound const& bound1, SizeBound const& bound2)
+            {
+                return SizeBound(bound1.IsExact() && bound2.IsExact() ? std::min(bound1._size, bound2._size) : Unknown,
+                        std::min(bound1._maxSize, bound2._maxSize));
+            }
+
+        private:
+            static size_t Add(size_t size1, size_t size2) { return size1 >= Unknown - size2 ? Unknown : size1 + size2; }
+        };
+
+        template <class Iterator>
+        SizeBound GetSizeBound(Iterator const& first, Iterator const& last);
+
+        template <class RandomIterator>
+        auto InternalGetSizeBound(RandomIterator const& first, RandomIterator const& last, int)
+            -> std::enable_if_t<std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<RandomIterator>::iterator_category>::value, SizeBound>
+        {
+            auto size = last - first;
+            return SizeBound::Exactly(size > 0 ? static_cast<size_t>(size) : 0);
+        }
+
+        // Iterators of operators such as Select or Where derive their bound from their sources.
+        template <class Iterator>
+        auto InternalGetSizeBound(Iterator const& first, Iterator const& last, long) -> decltype(first.GetSizeBound(last))
+        {
+            return first.GetSizeBound(last);
+        }
+
+        template <class BidirectionalIterator>
+        SizeBound InternalGetSizeBound(std::reverse_iterator<BidirectionalIterator> const& first, std::reverse_iterator<BidirectionalIterator> const& last, long)
+        {
+            return GetSizeBound(last.base(), first.base());
+        }
+
+        template <class Iterator>
+        SizeBound InternalGetSizeBound(Iterator const&, Iterator const&, ...) { return SizeBound(); }
+
+        // Exact for random access iterators and for those of operators that keep the size of sized sources,
+        // e.g. Select, Concat, Zip, Take or Reverse. Operators like Where or Distinct give an upper bound.
+        template <class Iterator>
+        SizeBound GetSizeBound(Iterator const& first, Iterator const& last) { return InternalGetSizeBound(first, last, 0); }
+
+        template <class Container>
+        auto InternalGetSizeBound(Container const& container, int) -> decltype(SizeBound::Exactly(container.size()))
+        {
+            return SizeBound::Exactly(container.size());
+        }
+
+        template <class Enumerable>
+        SizeBound InternalGetSizeBound(Enumerable const& enumerable, long) { return GetSizeBound(enumerable.begin(), enumerable.end()); }
+
+        // Containers know their size, all other enumerables know what their iterators do.
+        template <class Enumerable>
+        SizeBound GetSizeBound(Enumerable const& enumerable) { return InternalGetSizeBound(enumerable, 0); }
+
+        // Upper bounds are reserved up to this many bytes. Larger vectors grow as usual,
+        // since a bound such as the size of the source of a Where may be far off.
+        constexpr size_t MaxEstimatedBytes = size_t(1) << 24;
+
+        // Reserves the exact size if it is known, otherwise capacityHint or a small enough upper bound.
+        // Returns whether the reserved capacity is just an estimate.
+        template <class Vector>
+        bool Reserve(Vector& vector, SizeBound const& bound, size_t capacityHint)
+        {
+            if (bound.IsExact())
+            {
+                vector.reserve(bound.Size());
+                return false;
+            }
+
+            auto capacity = capacityHint;
+            if (capacity == 0 && bound.MaxSize() <= MaxEstimatedBytes / sizeof(*vector.data()))
+                capacity = bound.MaxSize();
+
+            vector.reserve(std::min(capacity, bound.MaxSize()));
+            return capacity != 0;
+        }
+
+        // Gives back an estimated capacity if less than half of it is used.
+        template <class Vector>
+        void ShrinkUnused(Vector& vector)
+        {
+            if (vector.size() < vector.capacity() / 2)
+                vector.shrink_to_fit();
+        }
+    }
+}
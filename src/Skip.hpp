@@ -22,7 +22,7 @@ namespace Linqpp
         template <class InputIterator>
         auto InternalGetEnumerableFromSkip(InputIterator first, InputIterator last, size_t n, std::input_iterator_tag)
         {
-            return GetEnumerableFromSkipWhile(first, last, [=](auto, size_t i) { return i < n; });
+            return GetEnumerableFromSkipWhile(first, last, SkipCount{ n });
         }
     }
 
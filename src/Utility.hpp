@@ -1,5 +1,10 @@
 #pragma once
 
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace Linqpp
 {
     namespace Utility
@@ -23,5 +28,74 @@ namespace Linqpp
 
         template <class Function>
         auto on_exit(Function function) { return OnExit<Function>(function); }
+
+        // Minimal replacement for C++17's std::optional, the value lives inside the object.
+        template <class T>
+        class Optional
+        {
+        private:
+            // Value-initialized, which keeps -Wmaybe-uninitialized from flagging reads that follow an Emplace.
+            std::aligned_storage_t<sizeof(T), alignof(T)> _storage{};
+            bool _hasValue = false;
+
+        public:
+            using value_type = T;
+
+        public:
+            Optional() = default;
+            ~Optional() { Reset(); }
+
+            Optional(T const& value) { Emplace(value); }
+            Optional(T&& value) { Emplace(std::move(value)); }
+
+            Optional(Optional const& other) { if (other._hasValue) Emplace(*other); }
+            Optional(Optional&& other) { if (other._hasValue) Emplace(std::move(*other)); }
+
+            Optional& operator=(Optional const& other)
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    if (other._hasValue)
+                        Emplace(*other);
+                }
+                return *this;
+            }
+
+            Optional& operator=(Optional&& other)
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    if (other._hasValue)
+                        Emplace(std::move(*other));
+                }
+                return *this;
+            }
+
+        public:
+            bool HasValue() const { return _hasValue; }
+
+            template <class... Args>
+            T& Emplace(Args&&... args)
+            {
+                Reset();
+                new (&_storage) T(std::forward<Args>(args)...);
+                _hasValue = true;
+                return **this;
+            }
+
+            void Reset()
+            {
+                if (!_hasValue)
+                    return;
+
+                (**this).~T();
+                _hasValue = false;
+            }
+
+            T& operator*() { return *reinterpret_cast<T*>(&_storage); }
+            T const& operator*() const { return *reinterpret_cast<T const*>(&_storage); }
+        };
     }
 }
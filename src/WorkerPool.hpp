@@ -0,0 +1,192 @@
+#pragma once
+
+#include <climits>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Process-wide pool of the threads that run yielding functions and the parallel parts of algorithms such as OrderBy.
+        // A busy pool never blocks: if no worker is idle, a new one is started.
+        // Up to Size() workers are kept idle for reuse after their job is done.
+        class WorkerPool
+        {
+        private:
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            std::deque<std::function<void()>> _jobs;
+            size_t _idleWorkers = 0;
+            size_t _startedWorkers = 0;
+            size_t _size = std::max(std::thread::hardware_concurrency(), 1u);
+            size_t _concurrency = std::max(std::thread::hardware_concurrency(), 1u);
+            size_t _stackSize = 0;
+            std::vector<int> _cpus;
+
+        public:
+            static WorkerPool& Instance()
+            {
+                // Never destroyed, detached workers may still wait on it during shutdown.
+                static auto* pInstance = new WorkerPool();
+                return *pInstance;
+            }
+
+            WorkerPool(WorkerPool const&) = delete;
+            WorkerPool(WorkerPool&&) = delete;
+            WorkerPool& operator=(WorkerPool const&) = delete;
+            WorkerPool& operator=(WorkerPool&&) = delete;
+
+        private:
+            WorkerPool() = default;
+
+        // Configuration
+        public:
+            size_t Size()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _size;
+            }
+
+            // Maximum number of idle workers kept alive. 0 starts a fresh thread for every job.
+            void SetSize(size_t size)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _size = size;
+                }
+                _cv.notify_all();
+            }
+
+            // Stack size of workers started from now on. 0 uses the system default.
+            void SetStackSize(size_t stackSize)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _stackSize = stackSize;
+            }
+
+            size_t Concurrency()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _concurrency;
+            }
+
+            // Number of threads, including the calling one, that parallel algorithms split their work among.
+            // Defaults to the number of CPUs. 1 runs them on the calling thread only.
+            void SetConcurrency(size_t concurrency)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _concurrency = std::max<size_t>(concurrency, 1);
+            }
+
+            // Workers started from now on are pinned round robin to the given CPUs. Empty disables pinning.
+            void SetCpuAffinity(std::vector<int> cpus)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cpus = std::move(cpus);
+            }
+
+        public:
+            // Number of workers waiting for a job right now.
+            size_t IdleWorkers()
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _idleWorkers;
+            }
+
+            void Run(std::function<void()> job)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                if (_jobs.size() < _idleWorkers)
+                {
+                    _jobs.push_back(std::move(job));
+                    lock.unlock();
+                    _cv.notify_one();
+                    return;
+                }
+
+                StartWorker(std::move(job));
+            }
+
+        // Internals
+        private:
+            struct Worker
+            {
+                WorkerPool* pPool;
+                std::function<void()> job;
+            };
+
+            // Expects _mutex to be locked.
+            void StartWorker(std::function<void()> job)
+            {
+                pthread_attr_t attributes;
+                pthread_attr_init(&attributes);
+
+                if (_stackSize != 0)
+                    pthread_attr_setstacksize(&attributes, std::max<size_t>(_stackSize, PTHREAD_STACK_MIN));
+
+#ifdef __linux__
+                if (!_cpus.empty())
+                {
+                    cpu_set_t cpuSet;
+                    CPU_ZERO(&cpuSet);
+                    CPU_SET(_cpus[_startedWorkers % _cpus.size()], &cpuSet);
+                    pthread_attr_setaffinity_np(&attributes, sizeof(cpuSet), &cpuSet);
+                }
+#endif
+
+                auto spWorker = std::make_unique<Worker>(Worker{ this, std::move(job) });
+                pthread_t thread;
+                int error = pthread_create(&thread, &attributes, &WorkerPool::WorkerMain, spWorker.get());
+                pthread_attr_destroy(&attributes);
+
+                if (error != 0)
+                    throw std::system_error(error, std::system_category(), "Could not start yielding thread.");
+
+                spWorker.release();
+                pthread_detach(thread);
+                ++_startedWorkers;
+            }
+
+            static void* WorkerMain(void* pArgument)
+            {
+                std::unique_ptr<Worker> spWorker(static_cast<Worker*>(pArgument));
+                auto& pool = *spWorker->pPool;
+                auto job = std::move(spWorker->job);
+                spWorker.reset();
+
+                while (true)
+                {
+                    job();
+                    job = nullptr;
+
+                    std::unique_lock<std::mutex> lock(pool._mutex);
+                    if (pool._idleWorkers >= pool._size)
+                        return nullptr;
+
+                    ++pool._idleWorkers;
+                    while (pool._jobs.empty() && pool._idleWorkers <= pool._size)
+                        pool._cv.wait(lock);
+
+                    --pool._idleWorkers;
+                    if (pool._jobs.empty())
+                        return nullptr;
+
+                    job = std::move(pool._jobs.front());
+                    pool._jobs.pop_front();
+                }
+            }
+        };
+    }
+}
@@ -1,47 +1,69 @@
 #pragma once
 
-#include <condition_variable>
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <memory>
-#include <mutex>
-#include <thread>
+#include <vector>
 
+#include "AtomicStatus.hpp"
+#include "Cancellation.hpp"
+#include "RangeCursor.hpp"
 #include "IEnumerable.hpp"
+#include "WorkerPool.hpp"
+#include "YieldStatistics.hpp"
 #include "iterator/YieldingIterator.hpp"
 
+#ifdef LINQPP_YIELD_CONTEXT
+#include "ContextController.hpp"
+#endif
+
 namespace Linqpp
 {
     namespace Yielding
     {
         template <class T>
-        class ThreadController
+        class ThreadController : public std::enable_shared_from_this<ThreadController<T>>
         {
             enum class ThreadStatus
             {
                 Uninitialized,
                 ThreadIsWorking,
                 CallerIsWorking,
-                ThreadFinished
+                ThreadFinished,
+                ThreadCancelled
             };
 
         private:
-            std::thread _yieldingThread;
-            std::mutex _mutex;
-            std::condition_variable _cv;
-            std::unique_ptr<T> _spCurrentValue;
+            AtomicStatus<ThreadStatus> _threadStatus{ThreadStatus::Uninitialized};
             std::exception_ptr _spException;
-            ThreadStatus _threadStatus = ThreadStatus::Uninitialized;
+            size_t _batchSize;
 
-        public:
-            ThreadController() = default;
+            // Filled by the yielding thread, handed over to the caller as a whole.
+            std::vector<T> _pendingValues;
+            std::unique_ptr<RangeCursor<T>> _spPendingRange;
+
+            // Owned by the caller, drained without any synchronization.
+            // A delegated range is iterated after the values.
+            std::vector<T> _values;
+            size_t _position = 0;
+            std::unique_ptr<RangeCursor<T>> _spRange;
+            bool _isInitialized = false;
 
-            ~ThreadController()
+            // Set before initialization only, nullptr unless statistics are enabled.
+            std::shared_ptr<YieldStatistics> _spStatistics;
+
+        public:
+            explicit ThreadController(size_t batchSize = 1)
+                : _batchSize(std::max<size_t>(batchSize, 1))
             {
-                if (_yieldingThread.joinable())
-                    _yieldingThread.join();
+                _pendingValues.reserve(_batchSize);
+                _values.reserve(_batchSize);
             }
 
+            ~ThreadController() = default;
+
             ThreadController(ThreadController const&) = delete;
             ThreadController(ThreadController&&) = delete;
             ThreadController& operator=(ThreadController const&) = delete;
@@ -50,69 +72,84 @@ namespace Linqpp
         // Methods to be called from main thread only
         public:
             template <class YieldingFunction>
-            void Initialize(YieldingFunction yieldingFunction, std::weak_ptr<ThreadController> spThreadController)
+            void Initialize(YieldingFunction yieldingFunction)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-
-                if (_threadStatus != ThreadStatus::Uninitialized)
+                if (_isInitialized)
                     throw std::logic_error("Attempt to assign a new yielding thread to already initialized thread controller.");
 
-                _threadStatus = ThreadStatus::ThreadIsWorking;
-                _yieldingThread = std::thread(std::move(yieldingFunction), std::move(spThreadController));
+                _threadStatus.Store(ThreadStatus::ThreadIsWorking);
+                _isInitialized = true;
+
+                // The yielding thread keeps the controller alive on its own while accessing it,
+                // so there is nothing to join: the worker just returns to the pool when done.
+                auto spThreadController = std::weak_ptr<ThreadController>(this->shared_from_this());
+                WorkerPool::Instance().Run([yieldingFunction = std::move(yieldingFunction), spThreadController = std::move(spThreadController)]() mutable
+                {
+                    yieldingFunction(std::move(spThreadController));
+                });
+
+                AwaitThread();
+                TakeValues();
 
-                while (_threadStatus == ThreadStatus::ThreadIsWorking)
-                    _cv.wait(lock);
+                while (MustResume())
+                    Resume();
             }
 
-            bool IsInitialized()
+            bool IsInitialized() const { return _isInitialized; }
+
+            void SetStatistics(std::shared_ptr<YieldStatistics> spStatistics)
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                return _threadStatus != ThreadStatus::Uninitialized;
+                if (_isInitialized)
+                    throw std::logic_error("Statistics have to be set before the thread controller is initialized.");
+
+                _spStatistics = std::move(spStatistics);
             }
 
+            std::shared_ptr<YieldStatistics const> GetStatistics() const { return _spStatistics; }
+
             T AwaitValueFromThread()
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-
-                if (_threadStatus == ThreadStatus::Uninitialized)
+                if (!_isInitialized)
                     throw std::runtime_error("Thread controller has not been initialized yet.");
 
-                while (_threadStatus == ThreadStatus::ThreadIsWorking)
-                    _cv.wait(lock);
+                if (_position < _values.size())
+                    return std::move(_values[_position]);
+
+                if (!HasValue() && _spException)
+                    std::rethrow_exception(_spException);
 
-                return std::move(*_spCurrentValue);
+                return _spRange->Get();
             }
 
             void ContinueYieldingThread()
             {
-                {
-                    std::unique_lock<std::mutex> lock(_mutex);
-
-                    if (_threadStatus == ThreadStatus::Uninitialized)
-                        throw std::runtime_error("Thread controller has not been initialized yet.");
+                if (!_isInitialized)
+                    throw std::runtime_error("Thread controller has not been initialized yet.");
 
-                    if (_threadStatus == ThreadStatus::ThreadFinished)
-                        return;
+                if (_position < _values.size())
+                    ++_position;
+                else if (_spRange)
+                    _spRange->Increment();
 
-                    _threadStatus = ThreadStatus::ThreadIsWorking;
-                }
-                _cv.notify_one();
+                if (HasValue() || _threadStatus.Load() == ThreadStatus::ThreadFinished)
+                    return;
 
+                do
                 {
-                    std::unique_lock<std::mutex> lock(_mutex);
+                    Resume();
+                } while (MustResume());
 
-                    while (_threadStatus == ThreadStatus::ThreadIsWorking)
-                        _cv.wait(lock);
-
-                    if (_spException)
-                        std::rethrow_exception(_spException);
-                }
+                if (!HasValue() && _spException)
+                    std::rethrow_exception(_spException);
             }
 
-            bool IsFinished()
+            bool IsFinished() const { return !HasValue() && _threadStatus.Load() == ThreadStatus::ThreadFinished; }
+
+            // Lets the waiting yielding thread unwind and return to the pool.
+            void Cancel()
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                return _threadStatus == ThreadStatus::ThreadFinished;
+                if (_isInitialized)
+                    _threadStatus.CompareExchange(ThreadStatus::CallerIsWorking, ThreadStatus::ThreadCancelled);
             }
 
         // Methods to be called from yielding thread only
@@ -120,55 +157,104 @@ namespace Linqpp
             template <class _T>
             void PassValueToCaller(_T&& t)
             {
-                {
-                    std::unique_lock<std::mutex> lock(_mutex);
-                    _spCurrentValue = std::make_unique<T>(std::forward<_T>(t));
-                    _threadStatus = ThreadStatus::CallerIsWorking;
-                }
-                _cv.notify_all();
+                _pendingValues.emplace_back(std::forward<_T>(t));
+
+                if (_spStatistics)
+                    _spStatistics->AddValue();
+
+                if (_pendingValues.size() < _batchSize)
+                    return;
+
                 WaitForCaller();
             }
 
-            void PassExceptionToCaller(std::exception_ptr spException)
+            template <class Container>
+            void PassRangeToCaller(Container&& container)
             {
-                {
-                    std::unique_lock<std::mutex> lock(_mutex);
-                    _spException = std::move(spException);
-                    _threadStatus = ThreadStatus::CallerIsWorking;
-                }
-                _cv.notify_all();
+                _spPendingRange = CreateRangeCursor<T>(std::forward<Container>(container));
                 WaitForCaller();
             }
 
-            void PassThreadFinishedNotificationToCaller()
+            void PassExceptionToCaller(std::exception_ptr spException)
             {
-                {
-                    std::unique_lock<std::mutex> lock(_mutex);
-                    _threadStatus = ThreadStatus::ThreadFinished;
-                }
-                _cv.notify_all();
+                // Nobody is left to take the exception once the function is cancelled. Throwing Cancellation from here
+                // would escape END_YIELDING's handler, so the function just finishes instead.
+                _spException = std::move(spException);
+                if (_threadStatus.CompareExchange(ThreadStatus::ThreadIsWorking, ThreadStatus::CallerIsWorking))
+                    AwaitCaller();
             }
 
+            void PassThreadFinishedNotificationToCaller() { _threadStatus.Store(ThreadStatus::ThreadFinished); }
+
         private:
+            // A cancelled function stays cancelled, even if it swallowed a Cancellation and yields again.
             void WaitForCaller()
             {
-                std::unique_lock<std::mutex> lock(_mutex);
+                if (!_threadStatus.CompareExchange(ThreadStatus::ThreadIsWorking, ThreadStatus::CallerIsWorking)
+                        || AwaitCaller() == ThreadStatus::ThreadCancelled)
+                    throw Cancellation();
+            }
+
+            ThreadStatus AwaitCaller()
+            {
+                if (!_spStatistics)
+                    return _threadStatus.WaitWhile(ThreadStatus::CallerIsWorking);
 
-                while (_threadStatus == ThreadStatus::CallerIsWorking)
-                    _cv.wait(lock);
+                auto start = std::chrono::steady_clock::now();
+                auto status = _threadStatus.WaitWhile(ThreadStatus::CallerIsWorking);
+                _spStatistics->AddYieldingWait(std::chrono::steady_clock::now() - start);
+                return status;
+            }
+
+            void AwaitThread()
+            {
+                if (!_spStatistics)
+                {
+                    _threadStatus.WaitWhile(ThreadStatus::ThreadIsWorking);
+                    return;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                _threadStatus.WaitWhile(ThreadStatus::ThreadIsWorking);
+                _spStatistics->AddCallerWait(std::chrono::steady_clock::now() - start);
+            }
+
+            bool HasValue() const { return _position < _values.size() || (_spRange && !_spRange->IsAtEnd()); }
+
+            // An empty delegated range is no reason to bother the caller.
+            bool MustResume() const { return !HasValue() && !_spException && _threadStatus.Load() == ThreadStatus::CallerIsWorking; }
+
+            void Resume()
+            {
+                _threadStatus.Store(ThreadStatus::ThreadIsWorking);
+                AwaitThread();
+                TakeValues();
+            }
+
+            // Expects the yielding thread to wait or to be finished.
+            void TakeValues()
+            {
+                _values.clear();
+                _position = 0;
+                swap(_values, _pendingValues);
+                _spRange = std::move(_spPendingRange);
             }
         };
 
-        template <class T>
-        class YieldingEnumerable : public IEnumerable<YieldingIterator<T>>
+        template <class T, class Controller = ThreadController<T>>
+        class YieldingEnumerable : public IEnumerable<YieldingIterator<T, Controller>, YieldingEnumerable<T, Controller>>
         {
         private:
-            YieldingIterator<T> _first;
-            YieldingIterator<T> _last;
+            YieldingIterator<T, Controller> _first;
+            YieldingIterator<T, Controller> _last;
 
         public:
-            YieldingEnumerable(std::function<void(std::weak_ptr<Yielding::ThreadController<T>>)> yieldingFunction)
-                : _first(std::move(yieldingFunction)), _last()
+            YieldingEnumerable(std::function<void(std::weak_ptr<Controller>)> yieldingFunction)
+                : YieldingEnumerable(1, std::move(yieldingFunction))
+            { }
+
+            YieldingEnumerable(size_t batchSize, std::function<void(std::weak_ptr<Controller>)> yieldingFunction)
+                : _first(std::move(yieldingFunction), batchSize), _last()
             { }
 
             YieldingEnumerable(YieldingEnumerable const&) = default;
@@ -177,16 +263,41 @@ namespace Linqpp
             YieldingEnumerable& operator=(YieldingEnumerable&&) = default;
 
         public:
-            virtual YieldingIterator<T> begin() const override { return _first; }
-            virtual YieldingIterator<T> end() const override { return _last; }
+            YieldingIterator<T, Controller> begin() const { return _first; }
+            YieldingIterator<T, Controller> end() const { return _last; }
+
+        public:
+            // Statistics are shared by all copies and have to be enabled before the enumeration starts.
+            std::shared_ptr<YieldStatistics const> EnableStatistics()
+            {
+                auto spStatistics = std::make_shared<YieldStatistics>();
+                _first.SetStatistics(spStatistics);
+                return spStatistics;
+            }
+
+            // nullptr unless statistics are enabled.
+            std::shared_ptr<YieldStatistics const> GetStatistics() const { return _first.GetStatistics(); }
         };
     }
 }
 
-#define START_YIELDING(__type) \
+#define START_YIELDING(__type) START_YIELDING_BATCHED(__type, 1)
+
+// The yielding thread passes up to __batchSize values at once to the caller.
+#define START_YIELDING_BATCHED(__type, __batchSize) LINQPP_START_YIELDING(__type, __batchSize, Linqpp::Yielding::ThreadController)
+
+// Runs the yielding function on its own stack within the calling thread. The backend is part of the function's text,
+// so that a yielding function in a header is the same in every translation unit.
+#ifdef LINQPP_YIELD_CONTEXT
+#define START_YIELDING_CONTEXT(__type) LINQPP_START_YIELDING(__type, 1, Linqpp::Yielding::ContextController)
+#endif
+
+#define LINQPP_START_YIELDING(__type, __batchSize, __controller) \
     using __Type = __type; \
-    return Linqpp::Yielding::YieldingEnumerable<__Type>([=](std::weak_ptr<Linqpp::Yielding::ThreadController<__Type>> __spThreadController) mutable \
+    using __Controller = __controller<__Type>; \
+    return Linqpp::Yielding::YieldingEnumerable<__Type, __Controller>(__batchSize, [=](std::weak_ptr<__Controller> __spThreadController) mutable \
     { \
+        std::exception_ptr __spException; \
         try \
         {
 
@@ -197,15 +308,39 @@ namespace Linqpp
                     __spThreadController2->PassValueToCaller(__value); \
             }
 
+// Passes all elements of the given container or enumerable to the caller, who iterates them directly.
+#define yield_from(__container) \
+            { \
+                auto __spThreadController2 = __spThreadController.lock(); \
+                if (__spThreadController2) \
+                    __spThreadController2->PassRangeToCaller(__container); \
+            }
+
+// Ends the yielding function, may only be used outside of nested lambdas.
+#define yield_break \
+            { \
+                auto __spThreadController2 = __spThreadController.lock(); \
+                if (__spThreadController2) \
+                    __spThreadController2->PassThreadFinishedNotificationToCaller(); \
+                return; \
+            }
+
+// The exception is passed once its handler is left, so that the function never waits within a handler. A yielding
+// context shares the exception state of the thread with the caller, and resuming it from within another handler
+// would end the wrong one.
 #define END_YIELDING \
         } \
+        catch (Linqpp::Yielding::Cancellation const&) \
+        { \
+            return; \
+        } \
         catch (...) \
         { \
-            auto __spThreadController2 = __spThreadController.lock(); \
-            if (__spThreadController2) \
-                __spThreadController2->PassExceptionToCaller(std::current_exception()); \
+            __spException = std::current_exception(); \
         } \
         auto __spThreadController2 = __spThreadController.lock(); \
+        if (__spThreadController2 && __spException) \
+            __spThreadController2->PassExceptionToCaller(std::move(__spException)); \
         if (__spThreadController2) \
             __spThreadController2->PassThreadFinishedNotificationToCaller(); \
     });
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Linqpp
+{
+    namespace Yielding
+    {
+        // Counters of a single yielding function, collected by its controller once enabled.
+        // They can be read at any time, e.g. to export them as metrics while the function runs.
+        class YieldStatistics
+        {
+        public:
+            // Bucket i counts the handoffs that kept the caller waiting for [2^i, 2^(i+1)) nanoseconds.
+            static constexpr size_t HistogramSize = 40;
+
+        private:
+            std::atomic<std::uint64_t> _values{0};
+            std::atomic<std::uint64_t> _handoffs{0};
+            std::atomic<std::uint64_t> _callerWaitNanoseconds{0};
+            std::atomic<std::uint64_t> _yieldingWaitNanoseconds{0};
+            std::array<std::atomic<std::uint64_t>, HistogramSize> _latencyHistogram{};
+
+        public:
+            YieldStatistics() = default;
+
+            YieldStatistics(YieldStatistics const&) = delete;
+            YieldStatistics& operator=(YieldStatistics const&) = delete;
+
+        public:
+            // Values passed by yield_return. A range passed by yield_from is not counted element by element.
+            std::uint64_t Values() const { return _values.load(std::memory_order_relaxed); }
+
+            // Number of times the caller had to wait for the yielding function.
+            std::uint64_t Handoffs() const { return _handoffs.load(std::memory_order_relaxed); }
+
+            std::chrono::nanoseconds CallerWaitTime() const { return std::chrono::nanoseconds(_callerWaitNanoseconds.load(std::memory_order_relaxed)); }
+            std::chrono::nanoseconds YieldingWaitTime() const { return std::chrono::nanoseconds(_yieldingWaitNanoseconds.load(std::memory_order_relaxed)); }
+
+            std::array<std::uint64_t, HistogramSize> LatencyHistogram() const
+            {
+                std::array<std::uint64_t, HistogramSize> histogram;
+                for (size_t i = 0; i < HistogramSize; ++i)
+                    histogram[i] = _latencyHistogram[i].load(std::memory_order_relaxed);
+
+                return histogram;
+            }
+
+        // Methods to be called from controllers only
+        public:
+            void AddValue() { _values.fetch_add(1, std::memory_order_relaxed); }
+
+            void AddCallerWait(std::chrono::nanoseconds duration)
+            {
+                auto nanoseconds = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+
+                _handoffs.fetch_add(1, std::memory_order_relaxed);
+                _callerWaitNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+                _latencyHistogram[Bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void AddYieldingWait(std::chrono::nanoseconds duration)
+            {
+                auto nanoseconds = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+                _yieldingWaitNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+            }
+
+        private:
+            static size_t Bucket(std::uint64_t nanoseconds)
+            {
+                size_t bucket = 0;
+                while (nanoseconds >>= 1)
+                    ++bucket;
+
+                return bucket < HistogramSize ? bucket : HistogramSize - 1;
+            }
+        };
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "IteratorAdapter.hpp"
+#include "../ForEach.hpp"
+#include "../Size.hpp"
 
 namespace Linqpp
 {
@@ -80,6 +82,28 @@ namespace Linqpp
                 }
             }
         }
+
+    // Push iteration
+    public:
+        template <class Sink>
+        bool ForEach(ConcatIterator const& last, Sink& sink) const
+        {
+            return Linqpp::ForEach(_current1, last._current1, sink) && Linqpp::ForEach(_current2, last._current2, sink);
+        }
+
+        template <class BlockSink, class Reference1 = reference1, class Reference2 = reference2>
+        auto ForEachBlock(ConcatIterator const& last, BlockSink& sink) const
+            -> std::enable_if_t<Detail::IsBlockElement<Reference1>::value && Detail::IsBlockElement<Reference2>::value, bool>
+        {
+            return Linqpp::ForEachBlock(_current1, last._current1, sink) && Linqpp::ForEachBlock(_current2, last._current2, sink);
+        }
+
+    // Size propagation
+    public:
+        Detail::SizeBound GetSizeBound(ConcatIterator const& last) const
+        {
+            return Detail::GetSizeBound(_current1, last._current1) + Detail::GetSizeBound(_current2, last._current2);
+        }
     };
 
     template <class Iterator1, class Iterator2>
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "IteratorAdapter.hpp"
+#include "../ForEach.hpp"
+
+#include <algorithm>
 
 namespace Linqpp
 {
@@ -40,6 +43,26 @@ namespace Linqpp
         void Decrement() { --_int; }
         difference_type Difference(IntIterator const& other) const { return _int - other._int; }
         void Move(difference_type n) { _int += n; }
+
+    // Push iteration
+    public:
+        template <class BlockSink>
+        bool ForEachBlock(IntIterator const& last, BlockSink& sink) const
+        {
+            Int buffer[Detail::BlockSize];
+            for (auto first = _int; first != last._int; )
+            {
+                size_t count = std::min<std::make_unsigned_t<Int>>(Detail::BlockSize, last._int - first);
+                for (size_t i = 0; i < count; ++i)
+                    buffer[i] = static_cast<Int>(first + i);
+
+                first += static_cast<Int>(count);
+                if (!sink(static_cast<Int const*>(buffer), count))
+                    return false;
+            }
+
+            return true;
+        }
     };
 
     template <class Int>
@@ -38,7 +38,7 @@ namespace Linqpp
         template <class difference_type> Iterator& operator+=(difference_type n) { This()->Move(n); return *This(); }
         template <class difference_type> Iterator& operator-=(difference_type n) { This()->Move(-n); return *This(); }
         auto operator-(Iterator const& other) const { return This()->Difference(other); }
-        template <class difference_type> decltype(auto) operator[](difference_type n) const { auto copy = *this; copy += n; return *copy; }
+        template <class difference_type> decltype(auto) operator[](difference_type n) const { auto copy = *This(); copy += n; return *copy; }
         bool operator<(Iterator const& other) const { return (*this - other) < 0; }
         bool operator<=(Iterator const& other) const { return (*this - other) <= 0; }
         bool operator>(Iterator const& other) const { return (*this - other) > 0; }
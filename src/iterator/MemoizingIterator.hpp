@@ -0,0 +1,186 @@
+#pragma once
+
+#include "IteratorAdapter.hpp"
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Linqpp
+{
+    template <class InputIterator>
+    auto From(InputIterator first, InputIterator last);
+
+    namespace Detail
+    {
+        // Elements read from the source so far, shared by all copies of a memoizing iterator.
+        // The source is only advanced as far as the furthest iterator needs.
+        // Chunks double in size and never move, so published elements are read without locking.
+        template <class InputIterator>
+        class MemoBuffer
+        {
+        public:
+            using value_type = typename std::iterator_traits<InputIterator>::value_type;
+
+        private:
+            using Storage = std::aligned_storage_t<sizeof(value_type), alignof(value_type)>;
+
+            static constexpr size_t FirstChunkSize = 64;
+            static constexpr size_t MaxChunks = 48;
+
+        // Fields
+        private:
+            std::mutex _mutex;
+            InputIterator _first;
+            InputIterator _last;
+            bool _isIncrementPending = false;
+            std::unique_ptr<Storage[]> _chunks[MaxChunks];
+            std::atomic<size_t> _size{0};
+
+        // Constructors, destructor
+        public:
+            MemoBuffer(InputIterator first, InputIterator last) : _first(first), _last(last) { }
+
+            ~MemoBuffer()
+            {
+                for (size_t i = 0, size = _size.load(); i < size; ++i)
+                    (*this)[i].~value_type();
+            }
+
+            MemoBuffer(MemoBuffer const&) = delete;
+            MemoBuffer& operator=(MemoBuffer const&) = delete;
+
+        public:
+            // Returns false if the source ends before the given index.
+            bool Fill(size_t index)
+            {
+                if (index < _size.load(std::memory_order_acquire))
+                    return true;
+
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                for (auto size = _size.load(std::memory_order_relaxed); size <= index; )
+                {
+                    // The source is advanced only once the next element is needed, which matters for yielding functions.
+                    if (_isIncrementPending)
+                    {
+                        ++_first;
+                        _isIncrementPending = false;
+                    }
+
+                    if (_first == _last)
+                        return false;
+
+                    new (Allocate(size)) value_type(*_first);
+                    _isIncrementPending = true;
+                    _size.store(++size, std::memory_order_release);
+                }
+
+                return true;
+            }
+
+            // Expects the given index to be filled.
+            value_type const& operator[](size_t index) const
+            {
+                size_t chunk, offset;
+                Locate(index, chunk, offset);
+                return *reinterpret_cast<value_type const*>(&_chunks[chunk][offset]);
+            }
+
+        // Internals
+        private:
+            // Expects _mutex to be locked.
+            Storage* Allocate(size_t index)
+            {
+                size_t chunk, offset;
+                Locate(index, chunk, offset);
+
+                if (!_chunks[chunk])
+                    _chunks[chunk] = std::make_unique<Storage[]>(FirstChunkSize << chunk);
+
+                return &_chunks[chunk][offset];
+            }
+
+            // Chunk i holds FirstChunkSize * 2^i elements and starts at index FirstChunkSize * (2^i - 1).
+            static void Locate(size_t index, size_t& chunk, size_t& offset)
+            {
+                auto n = index / FirstChunkSize + 1;
+
+                chunk = 0;
+                while (n >>= 1)
+                    ++chunk;
+
+                offset = index - FirstChunkSize * ((size_t(1) << chunk) - 1);
+            }
+        };
+    }
+
+    template <class InputIterator>
+    class MemoizingIterator : public IteratorAdapter<MemoizingIterator<InputIterator>>
+    {
+    // Types
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename std::iterator_traits<InputIterator>::value_type;
+        using reference = value_type const&;
+        using pointer = value_type const*;
+
+    // Fields
+    private:
+        // nullptr for the end iterator.
+        std::shared_ptr<Detail::MemoBuffer<InputIterator>> _spBuffer;
+        size_t _position = 0;
+
+    // Constructors, destructor
+    public:
+        explicit MemoizingIterator(std::shared_ptr<Detail::MemoBuffer<InputIterator>> spBuffer)
+            : _spBuffer(std::move(spBuffer))
+        { }
+
+        MemoizingIterator() = default;
+        MemoizingIterator(MemoizingIterator const&) = default;
+        MemoizingIterator(MemoizingIterator&&) = default;
+        MemoizingIterator& operator=(MemoizingIterator const&) = default;
+        MemoizingIterator& operator=(MemoizingIterator&&) = default;
+
+    // IteratorAdapter
+    public:
+        bool Equals(MemoizingIterator const& other) const
+        {
+            if (_spBuffer && other._spBuffer)
+                return _spBuffer == other._spBuffer && _position == other._position;
+
+            if (_spBuffer)
+                return !_spBuffer->Fill(_position);
+
+            if (other._spBuffer)
+                return !other._spBuffer->Fill(other._position);
+
+            return true;
+        }
+
+        reference Get() const
+        {
+            if (!_spBuffer || !_spBuffer->Fill(_position))
+                throw std::out_of_range("Memoizing iterator is at the end of its range.");
+
+            return (*_spBuffer)[_position];
+        }
+
+        void Increment() { ++_position; }
+    };
+
+    template <class InputIterator>
+    auto CreateMemoizingEnumerable(InputIterator first, InputIterator last)
+    {
+        static_assert(std::is_copy_assignable<MemoizingIterator<InputIterator>>::value, "MemoizingIterator is not copy assignable.");
+
+        auto spBuffer = std::make_shared<Detail::MemoBuffer<InputIterator>>(first, last);
+        return From(MemoizingIterator<InputIterator>(std::move(spBuffer)), MemoizingIterator<InputIterator>());
+    }
+}
@@ -2,13 +2,49 @@
 
 #include "IteratorAdapter.hpp"
 #include "DummyPointer.hpp"
-
-using namespace Linqpp::Detail;
+#include "../ForEach.hpp"
+#include "../Size.hpp"
+#include "../Utility.hpp"
 
 namespace Linqpp
 {
-    template <class InputIterator, class UnaryFunction>
-    class SelectIterator : public IteratorAdapter<SelectIterator<InputIterator, UnaryFunction>>
+    namespace Detail
+    {
+        // Keeps the value computed for the current position of an iterator until it moves.
+        template <class Reference, bool IsCaching>
+        class ResultCache
+        {
+        private:
+            Utility::Optional<std::remove_cv_t<Reference>> _value;
+
+        public:
+            template <class Compute>
+            Reference const& Get(Compute const& compute)
+            {
+                if (!_value.HasValue())
+                    _value.Emplace(compute());
+
+                return *_value;
+            }
+
+            void Reset() { _value.Reset(); }
+        };
+
+        template <class Reference>
+        class ResultCache<Reference, false>
+        {
+        public:
+            template <class Compute>
+            Reference Get(Compute const& compute) { return compute(); }
+
+            void Reset() { }
+        };
+    }
+
+    // With IsCaching, the result for the current position is computed at most once, however often it is dereferenced.
+    // That pays off for expensive functions only, since every dereference copies the cached result.
+    template <class InputIterator, class UnaryFunction, bool IsCaching = false>
+    class SelectIterator : public IteratorAdapter<SelectIterator<InputIterator, UnaryFunction, IsCaching>>
     {
     // Fields
     private:
@@ -20,7 +56,11 @@ namespace Linqpp
         using difference_type = typename std::iterator_traits<InputIterator>::difference_type;
         using reference = decltype(_function(*_iterator));
         using value_type = std::remove_reference_t<reference>;
-        using pointer = DummyPointer<value_type>;
+        using pointer = Detail::DummyPointer<value_type>;
+
+    private:
+        // References are cheap to recompute, and values that cannot be copied cannot be cached.
+        mutable Detail::ResultCache<reference, IsCaching && !std::is_reference<reference>::value && std::is_copy_constructible<reference>::value> _cache;
 
     // Constructors, destructor
     public:
@@ -41,12 +81,44 @@ namespace Linqpp
     // IteratorAdapter
     public:
         bool Equals(SelectIterator const& other) const { return _iterator == other._iterator; }
-        reference Get() const { return _function(*_iterator); }
-        pointer operator->() const { return CreateDummyPointer(Get()); }
-        void Increment() { ++_iterator; }
-        void Decrement() { --_iterator; }
+        reference Get() const { return _cache.Get([&]() -> reference { return _function(*_iterator); }); }
+        pointer operator->() const { return Detail::CreateDummyPointer(Get()); }
+        void Increment() { ++_iterator; _cache.Reset(); }
+        void Decrement() { --_iterator; _cache.Reset(); }
         difference_type Difference(SelectIterator const& other) const { return _iterator - other._iterator; }
-        void Move(difference_type n) { _iterator += n; }
+        void Move(difference_type n) { _iterator += n; _cache.Reset(); }
+
+    // Push iteration
+    public:
+        template <class Sink>
+        bool ForEach(SelectIterator const& last, Sink& sink) const
+        {
+            return Linqpp::ForEach(_iterator, last._iterator, [&](auto&& value) { return sink(_function(std::forward<decltype(value)>(value))); });
+        }
+
+        // Transforms whole blocks of the source.
+        template <class BlockSink, class Reference = reference>
+        auto ForEachBlock(SelectIterator const& last, BlockSink& sink) const
+            -> std::enable_if_t<Detail::IsBlockElement<Reference>::value && Detail::IsBlockElement<decltype(*std::declval<InputIterator>())>::value, bool>
+        {
+            std::decay_t<Reference> buffer[Detail::BlockSize];
+            return Linqpp::ForEachBlock(_iterator, last._iterator, [&](auto const* values, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    buffer[i] = _function(values[i]);
+
+                return sink(static_cast<std::decay_t<Reference> const*>(buffer), count);
+            });
+        }
+
+    // Size propagation
+    public:
+        Detail::SizeBound GetSizeBound(SelectIterator const& last) const { return Detail::GetSizeBound(_iterator, last._iterator); }
+
+    // Fused kernels
+    public:
+        InputIterator const& GetIterator() const { return _iterator; }
+        UnaryFunction const& GetFunction() const { return _function; }
 
     // Internals
     private:
@@ -60,20 +132,22 @@ namespace Linqpp
             using std::swap;
             swap(iterator1._iterator, iterator2._iterator);
             swap(iterator1._function, iterator2._function);
+            swap(iterator1._cache, iterator2._cache);
         }
 
         static void Swap(SelectIterator& iterator1, SelectIterator& iterator2, std::false_type)
         {
             using std::swap;
             swap(iterator1._iterator, iterator2._iterator);
+            swap(iterator1._cache, iterator2._cache);
         }
     };
 
-    template <class InputIterator, class UnaryFunction>
+    template <bool IsCaching = false, class InputIterator, class UnaryFunction>
     auto CreateSelectIterator(InputIterator iterator, UnaryFunction function)
     {
-        static_assert(std::is_copy_assignable<SelectIterator<InputIterator, UnaryFunction>>::value, "SelectIterator is not copy assignable.");
+        static_assert(std::is_copy_assignable<SelectIterator<InputIterator, UnaryFunction, IsCaching>>::value, "SelectIterator is not copy assignable.");
 
-        return SelectIterator<InputIterator, UnaryFunction>(iterator, function);
+        return SelectIterator<InputIterator, UnaryFunction, IsCaching>(iterator, function);
     }
 }
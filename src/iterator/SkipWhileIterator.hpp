@@ -2,11 +2,25 @@
 
 #include "../From.hpp"
 #include "IteratorAdapter.hpp"
+#include "../ForEach.hpp"
+#include "../Size.hpp"
 
 #include <algorithm>
 
 namespace Linqpp
 {
+    namespace Detail
+    {
+        // The predicate of Skip(n) for sequences without random access, which skips a known number of elements.
+        struct SkipCount
+        {
+            size_t n;
+
+            template <class T>
+            bool operator()(T const&, size_t index) const { return index < n; }
+        };
+    }
+
     template <class InputIterator, class Predicate>
     class SkipWhileIterator : public IteratorAdapter<SkipWhileIterator<InputIterator, Predicate>>
     {
@@ -75,7 +89,42 @@ namespace Linqpp
             --_first;
         }
 
+    // Push iteration
+    public:
+        template <class Sink>
+        bool ForEach(SkipWhileIterator const& last, Sink& sink) const
+        {
+            if (_isInitialized)
+                return Linqpp::ForEach(_first, last._first, sink);
+
+            size_t index = 0;
+            bool isSkipping = true;
+            return Linqpp::ForEach(_first, last._first, [&](auto&& value)
+            {
+                if (isSkipping && IsSkipped(value, index++))
+                    return true;
+
+                isSkipping = false;
+                return sink(std::forward<decltype(value)>(value));
+            });
+        }
+
+    // Size propagation
+    public:
+        Detail::SizeBound GetSizeBound(SkipWhileIterator const& last) const { return SkipBound(Detail::GetSizeBound(_first, last._first), _predicate); }
+
     private:
+        Detail::SizeBound SkipBound(Detail::SizeBound const& bound, Detail::SkipCount const& skip) const { return _isInitialized ? bound : bound.Skip(skip.n); }
+
+        template <class P>
+        Detail::SizeBound SkipBound(Detail::SizeBound const& bound, P const&) const { return bound.Filtered(); }
+
+        template <class T, class P = Predicate>
+        bool IsSkipped(T const& value, size_t, decltype(std::declval<P>()(*_first))* = nullptr) const { return _predicate(value); }
+
+        template <class T, class P = Predicate>
+        bool IsSkipped(T const& value, size_t index, decltype(std::declval<P>()(*_first, 0))* = nullptr) const { return _predicate(value, index); }
+
         template <class P = Predicate>
         void Initialize(decltype(std::declval<P>()(*_first))* = nullptr) const
         {
@@ -1,41 +1,412 @@
 #pragma once
 
+#include "../ForEach.hpp"
 #include "../From.hpp"
+#include "../RadixSort.hpp"
+#include "../Size.hpp"
 #include "IteratorAdapter.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Linqpp
 {
-    template <class InputIterator, class LessThanComparer>
-    class SortingIterator : public IteratorAdapter<SortingIterator<InputIterator, LessThanComparer>>
+    namespace Detail
+    {
+        // Sorts lazily like an incremental quicksort: an element is put in place when it is accessed, by partitioning
+        // only the unsorted segment that contains it. Getting the first k of n elements costs O(n + k log k) on average,
+        // getting all of them costs about as much as a quicksort. Data split into SortedSegments has them sorted by their own sort instead.
+        // Large segments that are sorted completely are sorted in parallel, by ParallelMergeSort if IsParallel, which
+        // requires a total order and copyable elements, and several segments of SortedSegments at once otherwise.
+        // Copies of a sorted sequence share it, also across threads: elements in place never move again and are read
+        // without locking, while putting elements in place is serialized.
+        template <class Vector, bool IsParallel = false>
+        class IncrementalSort
+        {
+        private:
+            static constexpr size_t SortThreshold = 32;
+
+        private:
+            std::mutex _mutex;
+            Vector _data;
+
+            // Maps the beginning of each unsorted segment to its end and its number of partitionings so far.
+            // All elements of a segment belong in it, and all elements outside of segments are in place.
+            std::map<size_t, std::pair<size_t, size_t>> _segments;
+            std::atomic<size_t> _sortedPrefix{0};
+            size_t _maxDepth = 0;
+
+            // Sorts segments of data split into SortedSegments completely instead of partitioning them.
+            std::function<void(Vector&, size_t, size_t)> _sortSegment;
+
+        public:
+            size_t Size() const { return _data.size(); }
+
+            // Expects to be called once, before any other thread accesses the data.
+            void Load(Vector data, SortedSegments<Vector> segments = { })
+            {
+                _data = std::move(data);
+                _sortSegment = std::move(segments.sort);
+
+                if (!_sortSegment)
+                    AddSegment(0, _data.size(), 0);
+
+                for (size_t i = 1; i < segments.bounds.size(); ++i)
+                    AddSegment(segments.bounds[i - 1], segments.bounds[i], 0);
+
+                _sortedPrefix = _segments.empty() ? _data.size() : _segments.begin()->first;
+                _maxDepth = 2 * static_cast<size_t>(std::log2(_data.size() + 1));
+            }
+
+            template <class LessThanComparer>
+            typename Vector::reference Get(size_t position, LessThanComparer const& comparer)
+            {
+                if (position >= _sortedPrefix.load(std::memory_order_acquire))
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    Place(position, comparer);
+                }
+
+                return _data[position];
+            }
+
+        private:
+            // Expects _mutex to be locked. Does nothing if the position has been put in place in the meantime.
+            template <class LessThanComparer>
+            void Place(size_t position, LessThanComparer const& comparer)
+            {
+                auto segment = _segments.upper_bound(position);
+                if (segment == _segments.begin() || (--segment)->second.first <= position)
+                    return;
+
+                if (_sortSegment)
+                    SortSegments(segment, position);
+                else
+                {
+                    auto first = segment->first;
+                    auto last = segment->second.first;
+                    auto depth = segment->second.second;
+                    _segments.erase(segment);
+                    Sort(first, last, depth, position, comparer);
+                }
+
+                _sortedPrefix = _segments.empty() ? _data.size() : _segments.begin()->first;
+            }
+
+            template <class LessThanComparer>
+            void Sort(size_t first, size_t last, size_t depth, size_t position, LessThanComparer const& comparer)
+            {
+                while (IsWorthPartitioning(first, last, depth, position))
+                {
+                    auto cut = Partition(first, last, comparer);
+                    ++depth;
+
+                    if (position < cut)
+                    {
+                        AddSegment(cut, last, depth);
+                        last = cut;
+                    }
+                    else
+                    {
+                        AddSegment(first, cut, depth);
+                        first = cut;
+                    }
+                }
+
+                SortCompletely(first, last, comparer, std::integral_constant<bool, IsParallel>());
+            }
+
+            template <class LessThanComparer>
+            void SortCompletely(size_t first, size_t last, LessThanComparer const& comparer, std::true_type)
+            {
+                auto threads = Yielding::WorkerPool::Instance().Concurrency();
+                if (last - first >= ParallelSortThreshold && threads > 1)
+                    ParallelMergeSort(_data, first, last, comparer, threads);
+                else
+                    std::sort(_data.begin() + first, _data.begin() + last, comparer);
+            }
+
+            template <class LessThanComparer>
+            void SortCompletely(size_t first, size_t last, LessThanComparer const& comparer, std::false_type)
+            {
+                std::sort(_data.begin() + first, _data.begin() + last, comparer);
+            }
+
+            // Sorts the given segment of SortedSegments. A consumer that went through more than ParallelSortThreshold
+            // elements in order gets the following segments up to twice as many elements sorted along in parallel.
+            template <class Segment>
+            void SortSegments(Segment segment, size_t position)
+            {
+                auto threads = Yielding::WorkerPool::Instance().Concurrency();
+                if (segment->first != _sortedPrefix || position < ParallelSortThreshold || threads < 2)
+                {
+                    auto first = segment->first;
+                    auto last = segment->second.first;
+                    _segments.erase(segment);
+                    _sortSegment(_data, first, last);
+                    return;
+                }
+
+                std::vector<std::pair<size_t, size_t>> bounds;
+                auto end = segment;
+                for (; end != _segments.end() && end->first < 2 * position; ++end)
+                    bounds.emplace_back(end->first, end->second.first);
+
+                _segments.erase(segment, end);
+                ParallelFor(bounds.size(), [&](size_t i) { _sortSegment(_data, bounds[i].first, bounds[i].second); });
+            }
+
+            bool IsWorthPartitioning(size_t first, size_t last, size_t depth, size_t position) const
+            {
+                // Partitioning too often means bad pivots, std::sort then guarantees O(n log n).
+                if (last - first <= SortThreshold || depth >= _maxDepth)
+                    return false;
+
+                // A consumer that went through more sorted elements than the next segment holds
+                // will probably go through all of it, which std::sort does faster.
+                return first != _sortedPrefix || last - first > position;
+            }
+
+            void AddSegment(size_t first, size_t last, size_t depth)
+            {
+                if (last - first > 1)
+                    _segments.emplace(first, std::make_pair(last, depth));
+            }
+
+            // Like std::sort's partitioning: the median of three is the pivot, and the result cut divides
+            // the segment into elements not greater and elements not less than it.
+            template <class LessThanComparer>
+            size_t Partition(size_t first, size_t last, LessThanComparer const& comparer)
+            {
+                auto begin = _data.begin();
+                auto pivot = begin + first;
+                MoveMedianToFirst(pivot, pivot + 1, begin + (first + last) / 2, begin + (last - 1), comparer);
+
+                auto left = pivot + 1;
+                auto right = begin + last;
+                while (true)
+                {
+                    while (comparer(*left, *pivot))
+                        ++left;
+
+                    --right;
+                    while (comparer(*pivot, *right))
+                        --right;
+
+                    if (!(left < right))
+                        return left - begin;
+
+                    std::iter_swap(left, right);
+                    ++left;
+                }
+            }
+
+            template <class Iterator, class LessThanComparer>
+            static void MoveMedianToFirst(Iterator result, Iterator a, Iterator b, Iterator c, LessThanComparer const& comparer)
+            {
+                if (comparer(*a, *b))
+                {
+                    if (comparer(*b, *c))
+                        std::iter_swap(result, b);
+                    else if (comparer(*a, *c))
+                        std::iter_swap(result, c);
+                    else
+                        std::iter_swap(result, a);
+                }
+                else if (comparer(*a, *c))
+                    std::iter_swap(result, a);
+                else if (comparer(*b, *c))
+                    std::iter_swap(result, c);
+                else
+                    std::iter_swap(result, b);
+            }
+        };
+
+        template <class Key>
+        struct HoldsReferences : std::integral_constant<bool, std::is_reference<Key>::value> { };
+
+        template <class T>
+        struct HoldsReferences<std::reference_wrapper<T>> : std::true_type { };
+
+        template <class T1, class T2>
+        struct HoldsReferences<std::pair<T1, T2>> : std::integral_constant<bool, HoldsReferences<T1>::value || HoldsReferences<T2>::value> { };
+
+        template <class... T>
+        struct HoldsReferences<std::tuple<T...>> : std::integral_constant<bool,
+            !std::is_same<std::integer_sequence<bool, false, HoldsReferences<T>::value...>, std::integer_sequence<bool, HoldsReferences<T>::value..., false>>::value> { };
+
+        // Keys that can be computed once and sorted along with their elements. Keys such as std::tie(a, b) refer to
+        // the element they were computed from, which may be a temporary, and moving them would assign through the references.
+        template <class Key>
+        using IsStorableKey = std::integral_constant<bool, std::is_move_assignable<Key>::value && !HoldsReferences<Key>::value>;
+
+        // Elements sorted by comparing keys that are computed anew for each comparison, for keys that cannot be stored.
+        template <class Vector>
+        class SelectorSort
+        {
+        private:
+            IncrementalSort<Vector> _order;
+
+        public:
+            using reference = typename Vector::reference;
+
+        public:
+            size_t Size() const { return _order.Size(); }
+
+            template <class InputIterator, class KeySelector, class KeyComparer>
+            void Load(InputIterator first, InputIterator last, KeySelector const&, KeyComparer const&)
+            {
+                _order.Load(From(first, last).ToVector());
+            }
+
+            template <class KeySelector, class KeyComparer>
+            reference Get(size_t position, KeySelector const& keySelector, KeyComparer const& keyComparer)
+            {
+                return _order.Get(position, [&](auto const& value1, auto const& value2) { return keyComparer(keySelector(value1), keySelector(value2)); });
+            }
+        };
+
+        // Elements sorted by keys that are computed once per element, as pairs of a key and the index of its element.
+        // Ties are broken by the index, which keeps equivalent elements in their order and orders all pairs totally,
+        // so that large segments are sorted in parallel with the same result. Arithmetic keys compared by
+        // std::less or std::greater are radix sorted instead, and small elements that are cheap to move are then
+        // sorted along with their keys.
+        template <class Vector, class Key, class KeyComparer, class Value = typename Vector::value_type,
+                 bool = IsRadixSorted<Key, KeyComparer>::value && std::is_trivially_copyable<Value>::value && sizeof(Value) <= 2 * sizeof(size_t)>
+        class KeyedSort
+        {
+        private:
+            using Keys = std::vector<std::pair<Key, size_t>>;
+
+        private:
+            Vector _values;
+            IncrementalSort<Keys, std::is_copy_constructible<Key>::value> _order;
+
+        public:
+            using reference = typename Vector::reference;
+
+        public:
+            size_t Size() const { return _values.size(); }
+
+            template <class InputIterator, class KeySelector>
+            void Load(InputIterator first, InputIterator last, KeySelector const& keySelector, KeyComparer const& keyComparer)
+            {
+                _values = From(first, last).ToVector();
+
+                Keys keys;
+                keys.reserve(_values.size());
+                for (size_t i = 0; i < _values.size(); ++i)
+                    keys.emplace_back(keySelector(_values[i]), i);
+
+                auto segments = TryRadixSplit(keys, keyComparer);
+                _order.Load(std::move(keys), std::move(segments));
+            }
+
+            template <class KeySelector>
+            typename Vector::reference Get(size_t position, KeySelector const&, KeyComparer const& keyComparer)
+            {
+                return _values[_order.Get(position, Order(keyComparer)).second];
+            }
+
+        private:
+            static auto Order(KeyComparer const& keyComparer)
+            {
+                return [&keyComparer](auto const& key1, auto const& key2)
+                {
+                    if (keyComparer(key1.first, key2.first))
+                        return true;
+                    if (keyComparer(key2.first, key1.first))
+                        return false;
+                    return key1.second < key2.second;
+                };
+            }
+        };
+
+        template <class Vector, class Key, class KeyComparer, class Value>
+        class KeyedSort<Vector, Key, KeyComparer, Value, true>
+        {
+        private:
+            IncrementalSort<std::vector<std::pair<Key, Value>>> _order;
+
+        public:
+            using reference = Value&;
+
+        public:
+            size_t Size() const { return _order.Size(); }
+
+            template <class InputIterator, class KeySelector>
+            void Load(InputIterator first, InputIterator last, KeySelector const& keySelector, KeyComparer const& keyComparer)
+            {
+                std::vector<std::pair<Key, Value>> keys;
+                bool isEstimated = Reserve(keys, GetSizeBound(first, last), 0);
+
+                Linqpp::ForEach(first, last, [&](auto const& value)
+                {
+                    keys.emplace_back(keySelector(value), value);
+                    return true;
+                });
+
+                if (isEstimated)
+                    ShrinkUnused(keys);
+
+                auto segments = TryRadixSplit(keys, keyComparer);
+                _order.Load(std::move(keys), std::move(segments));
+            }
+
+            template <class KeySelector>
+            Value& Get(size_t position, KeySelector const&, KeyComparer const& keyComparer)
+            {
+                return _order.Get(position, [&](auto const& key1, auto const& key2) { return keyComparer(key1.first, key2.first); }).second;
+            }
+        };
+    }
+
+    template <class InputIterator, class KeySelector, class KeyComparer>
+    class SortingIterator : public IteratorAdapter<SortingIterator<InputIterator, KeySelector, KeyComparer>>
     {
         using Vector = std::vector<typename std::iterator_traits<InputIterator>::value_type>;
         using Traits = std::iterator_traits<typename Vector::iterator>;
+        using Key = std::decay_t<decltype(std::declval<KeySelector const&>()(std::declval<typename Traits::value_type&>()))>;
+        using Sort = std::conditional_t<Detail::IsStorableKey<Key>::value, Detail::KeyedSort<Vector, Key, KeyComparer>, Detail::SelectorSort<Vector>>;
+
+        // Loaded by the first copy that needs it, also if copies are used on several threads.
+        struct SharedSort
+        {
+            std::once_flag isLoaded;
+            Sort sort;
+        };
 
     public:
         using iterator_category = std::random_access_iterator_tag;
         using difference_type = typename Traits::difference_type;
         using value_type = typename Traits::value_type;
-        using reference = typename Traits::reference;
-        using pointer = typename Traits::pointer;
+        using reference = typename Sort::reference;
+        using pointer = std::add_pointer_t<value_type>;
 
     // Fields
     private:
         InputIterator _first;
         InputIterator _last;
-        std::shared_ptr<Vector> _spData = std::make_shared<Vector>();
+        std::shared_ptr<SharedSort> _spSort = std::make_shared<SharedSort>();
         mutable size_t _position = std::numeric_limits<size_t>::max();
-        LessThanComparer _comparer;
+        KeySelector _keySelector;
+        KeyComparer _keyComparer;
         mutable bool _isInitialized = false;
 
     // Constructors, destructor
     public:
-        SortingIterator(InputIterator first, InputIterator last, LessThanComparer comparer)
-            : _first(first), _last(last), _position(0), _comparer(std::move(comparer))
+        SortingIterator(InputIterator first, InputIterator last, KeySelector keySelector, KeyComparer keyComparer)
+            : _first(first), _last(last), _position(0), _keySelector(std::move(keySelector)), _keyComparer(std::move(keyComparer))
         { }
 
         SortingIterator() = default;
@@ -54,10 +425,10 @@ namespace Linqpp
         {
             EnsureInitialized();
             other.EnsureInitialized();
-            return _spData == other._spData && _position == other._position;
+            return _spSort == other._spSort && _position == other._position;
         }
 
-        reference Get() const { EnsureInitialized(); return (*_spData)[_position]; }
+        reference Get() const { EnsureInitialized(); return _spSort->sort.Get(_position, _keySelector, _keyComparer); }
         void Increment() { EnsureInitialized(); ++_position; }
         void Decrement() { EnsureInitialized(); --_position; }
 
@@ -73,10 +444,17 @@ namespace Linqpp
         auto GetEnd() const
         {
             auto end = *this;
-            end._position = _isInitialized ? _spData->size() : std::numeric_limits<size_t>::max();
+            end._position = _isInitialized ? _spSort->sort.Size() : std::numeric_limits<size_t>::max();
             return end;
         }
 
+    // Ordering
+    public:
+        InputIterator const& GetFirst() const { return _first; }
+        InputIterator const& GetLast() const { return _last; }
+        KeySelector const& GetKeySelector() const { return _keySelector; }
+        KeyComparer const& GetKeyComparer() const { return _keyComparer; }
+
     // Internals
     private:
         void EnsureInitialized() const
@@ -84,28 +462,25 @@ namespace Linqpp
             if (_isInitialized)
                 return;
 
-            if (_spData->empty())
-            {
-                *_spData = From(_first, _last).ToVector();
-                std::sort(_spData->begin(), _spData->end(), _comparer);
-            }
+            std::call_once(_spSort->isLoaded, [this] { _spSort->sort.Load(_first, _last, _keySelector, _keyComparer); });
 
             if (_position == std::numeric_limits<size_t>::max())
-                _position = _spData->size();
+                _position = _spSort->sort.Size();
 
             _isInitialized = true;
         }
 
         friend void swap(SortingIterator& iterator1, SortingIterator& iterator2)
         {
-            Swap(iterator1, iterator2, std::is_copy_assignable<LessThanComparer>());
+            Swap(iterator1, iterator2, std::integral_constant<bool, std::is_copy_assignable<KeySelector>::value && std::is_copy_assignable<KeyComparer>::value>());
         }
 
         static void Swap(SortingIterator& iterator1, SortingIterator& iterator2, std::true_type)
         {
             using std::swap;
             Swap(iterator1, iterator2, std::false_type());
-            swap(iterator1._comparer, iterator2._comparer);
+            swap(iterator1._keySelector, iterator2._keySelector);
+            swap(iterator1._keyComparer, iterator2._keyComparer);
         }
 
         static void Swap(SortingIterator& iterator1, SortingIterator& iterator2, std::false_type)
@@ -113,18 +488,9 @@ namespace Linqpp
             using std::swap;
             swap(iterator1._first, iterator2._first);
             swap(iterator1._last, iterator2._last);
-            swap(iterator1._spData, iterator2._spData);
+            swap(iterator1._spSort, iterator2._spSort);
             swap(iterator1._position, iterator2._position);
             swap(iterator1._isInitialized, iterator2._isInitialized);
         }
     };
-
-    template <class InputIterator, class LessThanComparer>
-    auto CreateSortedEnumerable(InputIterator first, InputIterator last, LessThanComparer comparer)
-    {
-        static_assert(std::is_copy_assignable<SortingIterator<InputIterator, LessThanComparer>>::value, "SortingIterator is not copy assignable.");
-
-        auto firstSorted = SortingIterator<InputIterator, LessThanComparer>(first, last, comparer);
-        return From(firstSorted, firstSorted.GetEnd());
-    }
 }
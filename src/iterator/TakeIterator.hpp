@@ -2,6 +2,8 @@
 
 #include "../From.hpp"
 #include "IteratorAdapter.hpp"
+#include "../ForEach.hpp"
+#include "../Size.hpp"
 
 #include <algorithm>
 
@@ -51,6 +53,38 @@ namespace Linqpp
 
             reference Get() const { return *_first; }
             void Increment() { ++_first; ++_position; }
+
+        // Push iteration
+        public:
+            // Unlike pull iteration, the source is not advanced past the last taken element.
+            template <class Sink>
+            bool ForEach(TakeIterator const& last, Sink& sink) const
+            {
+                if (_position >= last._position)
+                    return true;
+
+                auto remaining = last._position - _position;
+                bool isComplete = true;
+                Linqpp::ForEach(_first, last._first, [&](auto&& value)
+                {
+                    if (!sink(std::forward<decltype(value)>(value)))
+                        return isComplete = false;
+
+                    return --remaining != 0;
+                });
+
+                return isComplete;
+            }
+
+        // Size propagation
+        public:
+            Detail::SizeBound GetSizeBound(TakeIterator const& last) const
+            {
+                if (_position >= last._position)
+                    return Detail::SizeBound::Exactly(0);
+
+                return Detail::GetSizeBound(_first, last._first).Take(last._position - _position);
+            }
         };
 
         template <class InputIterator>
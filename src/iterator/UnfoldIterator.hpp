@@ -0,0 +1,122 @@
+#pragma once
+
+#include "IteratorAdapter.hpp"
+#include "DummyPointer.hpp"
+#include "../Utility.hpp"
+
+#include <cstddef>
+
+namespace Linqpp
+{
+    // Runs a state machine held inside the iterator: step(state) returns the next element
+    // as Utility::Optional, an empty one ends the sequence. No thread or context is involved.
+    template <class State, class Step>
+    class UnfoldIterator : public IteratorAdapter<UnfoldIterator<State, Step>>
+    {
+        using Optional = decltype(std::declval<Step&>()(std::declval<State&>()));
+
+    // Fields
+    private:
+        mutable State _state;
+        mutable Step _step;
+        mutable Optional _current;
+        mutable bool _isInitialized;
+        size_t _position = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename Optional::value_type;
+        using reference = value_type;
+        using pointer = Detail::DummyPointer<value_type>;
+
+    // Constructors, destructor
+    public:
+        // The end iterator is already initialized and never calls step.
+        UnfoldIterator(State state, Step step, bool isEnd = false)
+            : _state(std::move(state)), _step(std::move(step)), _isInitialized(isEnd)
+        { }
+
+        UnfoldIterator(UnfoldIterator const&) = default;
+        UnfoldIterator(UnfoldIterator&&) = default;
+
+        UnfoldIterator& operator=(UnfoldIterator other)
+        {
+            swap(*this, other);
+            return *this;
+        }
+
+    // IteratorAdapter
+    public:
+        bool Equals(UnfoldIterator const& other) const
+        {
+            if (!_isInitialized)
+                Initialize();
+
+            if (!other._isInitialized)
+                other.Initialize();
+
+            if (!_current.HasValue() || !other._current.HasValue())
+                return _current.HasValue() == other._current.HasValue();
+
+            return _position == other._position;
+        }
+
+        reference Get() const
+        {
+            if (!_isInitialized)
+                Initialize();
+
+            return *_current;
+        }
+
+        pointer operator->() const { return Detail::CreateDummyPointer(Get()); }
+
+        void Increment()
+        {
+            if (!_isInitialized)
+                Initialize();
+
+            _current = _step(_state);
+            ++_position;
+        }
+
+    // Internals
+    private:
+        // The first step is deferred until the iterator is used, like any other query.
+        void Initialize() const
+        {
+            _current = _step(_state);
+            _isInitialized = true;
+        }
+
+        friend void swap(UnfoldIterator& iterator1, UnfoldIterator& iterator2)
+        {
+            Swap(iterator1, iterator2, std::is_copy_assignable<Step>());
+        }
+
+        static void Swap(UnfoldIterator& iterator1, UnfoldIterator& iterator2, std::true_type)
+        {
+            using std::swap;
+            swap(iterator1._step, iterator2._step);
+            Swap(iterator1, iterator2, std::false_type());
+        }
+
+        static void Swap(UnfoldIterator& iterator1, UnfoldIterator& iterator2, std::false_type)
+        {
+            using std::swap;
+            swap(iterator1._state, iterator2._state);
+            swap(iterator1._current, iterator2._current);
+            swap(iterator1._isInitialized, iterator2._isInitialized);
+            swap(iterator1._position, iterator2._position);
+        }
+    };
+
+    template <class State, class Step>
+    auto CreateUnfoldIterator(State state, Step step, bool isEnd = false)
+    {
+        static_assert(std::is_copy_assignable<UnfoldIterator<State, Step>>::value, "UnfoldIterator is not copy assignable.");
+
+        return UnfoldIterator<State, Step>(std::move(state), std::move(step), isEnd);
+    }
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "IteratorAdapter.hpp"
+#include "../ForEach.hpp"
+#include "../Simd.hpp"
+#include "../Size.hpp"
 
 namespace Linqpp
 {
@@ -78,6 +81,35 @@ namespace Linqpp
             DecreaseUntilFit();
         }
 
+    // Push iteration
+    public:
+        // Filtering is cheaper than finding the first fit, so the initialization is not needed here.
+        template <class Sink>
+        bool ForEach(WhereIterator const& last, Sink& sink) const
+        {
+            return Linqpp::ForEach(_first, last._first, [&](auto&& value)
+            {
+                return !_predicate(value) || sink(std::forward<decltype(value)>(value));
+            });
+        }
+
+        // Compresses whole blocks of the source into a buffer of fits.
+        template <class BlockSink, class Reference = reference>
+        auto ForEachBlock(WhereIterator const& last, BlockSink& sink) const -> std::enable_if_t<Detail::IsBlockElement<Reference>::value, bool>
+        {
+            std::decay_t<Reference> buffer[Detail::BlockSize];
+            return Linqpp::ForEachBlock(_first, last._first, [&](auto const* values, size_t count)
+            {
+                auto fits = Detail::CompressBlock(values, count, _predicate, buffer);
+                return fits == 0 || sink(static_cast<std::decay_t<Reference> const*>(buffer), fits);
+            });
+        }
+
+    // Size propagation
+    public:
+        // Before the initialization, _first may still point before the first fit, which keeps the bound valid.
+        Detail::SizeBound GetSizeBound(WhereIterator const& last) const { return Detail::GetSizeBound(_first, last._first).Filtered(); }
+
     // Internals
     private:
         void Initialize() const
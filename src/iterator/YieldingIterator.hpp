@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <memory>
+#include <stdexcept>
 
 #include "IteratorAdapter.hpp"
 #include "DummyPointer.hpp"
@@ -12,37 +13,39 @@ namespace Linqpp
     {
         template <class T>
         class ThreadController;
+
+        class YieldStatistics;
     }
 
-    template <class T>
-    class YieldingIterator : public IteratorAdapter<YieldingIterator<T>>
+    template <class T, class Controller = Yielding::ThreadController<T>>
+    class YieldingIterator : public IteratorAdapter<YieldingIterator<T, Controller>>
     {
         static_assert(!std::is_reference<T>::value, "Yielding funtions cannot return reference types.");
 
     private:
-        mutable std::shared_ptr<Yielding::ThreadController<T>> _spThreadController;
-        std::function<void(std::weak_ptr<Yielding::ThreadController<T>>)> _yieldingFunction;
+        mutable std::shared_ptr<Controller> _spThreadController;
+        std::function<void(std::weak_ptr<Controller>)> _yieldingFunction;
 
     public:
         using iterator_category = std::input_iterator_tag;
         using value_type = T;
         using difference_type = std::ptrdiff_t;
         using reference = value_type;
-        using pointer = DummyPointer<value_type>;
+        using pointer = Detail::DummyPointer<value_type>;
 
     public:
-        YieldingIterator(std::function<void(std::weak_ptr<Yielding::ThreadController<T>>)> yieldingFunction)
-            : _spThreadController(std::make_shared<Yielding::ThreadController<T>>()), _yieldingFunction(std::move(yieldingFunction))
+        YieldingIterator(std::function<void(std::weak_ptr<Controller>)> yieldingFunction, size_t batchSize = 1)
+            : _spThreadController(CreateCancellingPointer(std::make_shared<Controller>(batchSize))), _yieldingFunction(std::move(yieldingFunction))
         { }
 
         YieldingIterator() = default;
-        YieldingIterator(YieldingIterator<T> const&) = default;
-        YieldingIterator(YieldingIterator<T>&&) = default;
-        YieldingIterator& operator=(YieldingIterator<T> const&) = default;
-        YieldingIterator& operator=(YieldingIterator<T>&&) = default;
+        YieldingIterator(YieldingIterator const&) = default;
+        YieldingIterator(YieldingIterator&&) = default;
+        YieldingIterator& operator=(YieldingIterator const&) = default;
+        YieldingIterator& operator=(YieldingIterator&&) = default;
 
     public:
-        bool Equals(YieldingIterator<T> const& other) const
+        bool Equals(YieldingIterator const& other) const
         {
             CheckInitialized();
             other.CheckInitialized();
@@ -55,7 +58,7 @@ namespace Linqpp
             return _spThreadController->AwaitValueFromThread();
         }
 
-        pointer operator->() const { return CreateDummyPointer(Get()); }
+        pointer operator->() const { return Detail::CreateDummyPointer(Get()); }
 
         void Increment()
         {
@@ -70,17 +73,39 @@ namespace Linqpp
                 MarkAsEndIterator();
         }
 
+    public:
+        void SetStatistics(std::shared_ptr<Yielding::YieldStatistics> spStatistics)
+        {
+            if (!_spThreadController || _spThreadController->IsInitialized())
+                throw std::logic_error("Statistics have to be enabled before the enumeration starts.");
+
+            _spThreadController->SetStatistics(std::move(spStatistics));
+        }
+
+        std::shared_ptr<Yielding::YieldStatistics const> GetStatistics() const
+        {
+            return _spThreadController ? _spThreadController->GetStatistics() : nullptr;
+        }
+
     private:
         void CheckInitialized() const
         {
             if (_spThreadController && !_spThreadController->IsInitialized())
             {
-                _spThreadController->Initialize(std::move(_yieldingFunction), _spThreadController);
+                _spThreadController->Initialize(std::move(_yieldingFunction));
                 if (_spThreadController->IsFinished())
                     MarkAsEndIterator();
             }
         }
 
         void MarkAsEndIterator() const { _spThreadController = nullptr; }
+
+        // All copies of the returned pointer cancel the yielding function when the last of them is gone.
+        // The yielding function itself only refers to the controller, not to this pointer.
+        static std::shared_ptr<Controller> CreateCancellingPointer(std::shared_ptr<Controller> spController)
+        {
+            auto pController = spController.get();
+            return std::shared_ptr<Controller>(pController, [spController = std::move(spController)](Controller*) { spController->Cancel(); });
+        }
     };
 }
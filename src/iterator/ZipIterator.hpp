@@ -4,8 +4,8 @@
 
 #include "IteratorAdapter.hpp"
 #include "DummyPointer.hpp"
-
-using namespace Linqpp::Detail;
+#include "../ForEach.hpp"
+#include "../Size.hpp"
 
 namespace Linqpp
 {
@@ -29,7 +29,7 @@ namespace Linqpp
         using value_type = decltype(_function(*_iterator1, *_iterator2));
         using difference_type = difference_type1;
         using reference = value_type;
-        using pointer = DummyPointer<value_type>;
+        using pointer = Detail::DummyPointer<value_type>;
 
     public:
         ZipIterator(InputIterator1 iterator1, InputIterator2 iterator2, BinaryFunction function)
@@ -50,12 +50,49 @@ namespace Linqpp
     public:
         bool Equals(ZipIterator const& other) const { return _iterator1 == other._iterator1 || _iterator2 == other._iterator2; }
         reference Get() const { return _function(*_iterator1, *_iterator2); }
-        pointer operator->() const { return CreateDummyPointer(Get()); }
+        pointer operator->() const { return Detail::CreateDummyPointer(Get()); }
         void Increment() { ++_iterator1; ++_iterator2; }
         void Decrement() { --_iterator1; --_iterator2; }
         difference_type Difference(ZipIterator const& other) const { return _iterator1 - other._iterator1; }
         void Move(difference_type n) { _iterator1 += n; _iterator2 += n; }
 
+    // Push iteration
+    public:
+        // Runs over whole blocks of the first source, the second one is read alongside.
+        template <class BlockSink, class Reference = reference>
+        auto ForEachBlock(ZipIterator const& last, BlockSink& sink) const
+            -> std::enable_if_t<Detail::IsBlockElement<Reference>::value && Detail::IsBlockElement<decltype(*std::declval<InputIterator1>())>::value, bool>
+        {
+            std::decay_t<Reference> buffer[Detail::BlockSize];
+            auto iterator2 = _iterator2;
+            bool isStopped = false;
+
+            Linqpp::ForEachBlock(_iterator1, last._iterator1, [&](auto const* values, size_t count)
+            {
+                size_t zipped = 0;
+                for (; zipped < count && iterator2 != last._iterator2; ++zipped, ++iterator2)
+                    buffer[zipped] = _function(values[zipped], *iterator2);
+
+                isStopped = zipped != 0 && !sink(static_cast<std::decay_t<Reference> const*>(buffer), zipped);
+                return !isStopped && zipped == count;
+            });
+
+            return !isStopped;
+        }
+
+    // Size propagation
+    public:
+        Detail::SizeBound GetSizeBound(ZipIterator const& last) const
+        {
+            return Min(Detail::GetSizeBound(_iterator1, last._iterator1), Detail::GetSizeBound(_iterator2, last._iterator2));
+        }
+
+    // Fused kernels
+    public:
+        InputIterator1 const& GetIterator1() const { return _iterator1; }
+        InputIterator2 const& GetIterator2() const { return _iterator2; }
+        BinaryFunction const& GetFunction() const { return _function; }
+
     // Internals
     private:
         friend void swap(ZipIterator& iterator1, ZipIterator& iterator2)
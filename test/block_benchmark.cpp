@@ -0,0 +1,58 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Linqpp.hpp"
+
+using namespace Linqpp;
+
+namespace
+{
+    auto Pipeline(std::vector<int> const& values)
+    {
+        return From(values).Where([](int i) { return i % 3 != 0; }).Select([](int i) { return 2 * i + 1; });
+    }
+
+    template <class Function>
+    void Measure(std::string const& name, size_t n, Function function)
+    {
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            checksum += function();
+        std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": " << duration.count() / n << " us per run (" << checksum << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    std::vector<int> values(1'000'000);
+    std::iota(values.begin(), values.end(), 0);
+
+    // Aggregate pushes element by element, Sum consumes blocks.
+    Measure("element-wise sum of Where/Select over 1M values", 100, [&] { return Pipeline(values).Aggregate(std::plus<>()); });
+    Measure("block-wise sum of Where/Select over 1M values", 100, [&] { return Pipeline(values).Sum(); });
+
+    Measure("element-wise count of Where/Select over 1M values", 100, [&] { return Pipeline(values).Count([](int) { return true; }); });
+    Measure("block-wise count of Where/Select over 1M values", 100, [&] { return Pipeline(values).Count(); });
+
+    std::vector<float> floats(values.begin(), values.end());
+    for (auto& f : floats)
+        f = static_cast<float>(static_cast<size_t>(f) * 7919 % 1000);
+
+    // Where with a selectivity of 5%.
+    auto isRare = [](float f) { return f < 50; };
+    Measure("element-wise count of Where over 1M floats", 100, [&] { return From(floats).Where(isRare).Aggregate(0, [](int n, float) { return n + 1; }); });
+    Measure("block-wise count of Where over 1M floats", 100, [&] { return From(floats).Where(isRare).Count(); });
+    Measure("element-wise sum of Where over 1M floats", 100, [&] { return From(floats).Where(isRare).Aggregate(std::plus<>()); });
+    Measure("block-wise sum of Where over 1M floats", 100, [&] { return From(floats).Where(isRare).Sum(); });
+    Measure("block-wise ToVector of Where over 1M floats", 100, [&] { return From(floats).Where(isRare).ToVector().size(); });
+
+    Measure("element-wise sum of Range/Select over 1M values", 100, [&] { return Enumerable::Range(0, 1'000'000).Select([](int i) { return i & 7; }).Aggregate(std::plus<>()); });
+    Measure("block-wise sum of Range/Select over 1M values", 100, [&] { return Enumerable::Range(0, 1'000'000).Select([](int i) { return i & 7; }).Sum(); });
+}
@@ -1,5 +1,12 @@
+#include <algorithm>
 #include <forward_list>
+#include <iterator>
 #include <list>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
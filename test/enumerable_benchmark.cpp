@@ -0,0 +1,72 @@
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Linqpp.hpp"
+
+using namespace Linqpp;
+
+namespace
+{
+    auto isOdd = [](int i) { return i % 2 != 0; };
+    auto triple = [](int i) { return 3 * i; };
+    auto isSmall = [](int i) { return i < 1'000'000; };
+    auto increment = [](int i) { return i + 2; };
+
+    template <class Enumerable>
+    auto StaticPipeline(Enumerable const& enumerable)
+    {
+        return enumerable.Where(isOdd).Select(triple).Where(isSmall).Select(increment)
+            .Where(isOdd).Select(triple).Where(isSmall).Select(increment);
+    }
+
+    // Every stage is built through the virtual interface IEnumerable<InputIterator>.
+    template <class Enumerable, class Function>
+    auto Erased(Enumerable const& enumerable, Function function)
+    {
+        auto erased = enumerable.AsEnumerable();
+        IEnumerable<decltype(erased.begin())> const& base = erased;
+        return function(base);
+    }
+
+    template <class Enumerable>
+    auto ErasedPipeline(Enumerable const& enumerable)
+    {
+        auto where1 = Erased(enumerable, [](auto const& e) { return e.Where(isOdd); });
+        auto select1 = Erased(where1, [](auto const& e) { return e.Select(triple); });
+        auto where2 = Erased(select1, [](auto const& e) { return e.Where(isSmall); });
+        auto select2 = Erased(where2, [](auto const& e) { return e.Select(increment); });
+        auto where3 = Erased(select2, [](auto const& e) { return e.Where(isOdd); });
+        auto select3 = Erased(where3, [](auto const& e) { return e.Select(triple); });
+        auto where4 = Erased(select3, [](auto const& e) { return e.Where(isSmall); });
+        return Erased(where4, [](auto const& e) { return e.Select(increment); });
+    }
+
+    template <class Function>
+    void Measure(std::string const& name, size_t n, Function function)
+    {
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            checksum += function();
+        std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": " << duration.count() / n << " ns per run (" << checksum << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    std::vector<int> small(16);
+    std::iota(small.begin(), small.end(), 0);
+
+    std::vector<int> large(1'000'000);
+    std::iota(large.begin(), large.end(), 0);
+
+    Measure("static, 8 stages over 16 values", 200'000, [&] { return StaticPipeline(From(small)).Sum(); });
+    Measure("erased, 8 stages over 16 values", 200'000, [&] { return ErasedPipeline(From(small)).Sum(); });
+    Measure("static, 8 stages over 1M values", 20, [&] { return StaticPipeline(From(large)).Count(); });
+    Measure("erased, 8 stages over 1M values", 20, [&] { return ErasedPipeline(From(large)).Count(); });
+}
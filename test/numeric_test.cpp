@@ -1,7 +1,18 @@
+#include <algorithm>
+#include <atomic>
 #include <complex>
+#include <cstdint>
+#include <functional>
 #include <forward_list>
+#include <iterator>
 #include <limits>
 #include <list>
+#include <numeric>
+#include <utility>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "Linqpp.hpp"
@@ -9,6 +20,17 @@
 
 using namespace Linqpp;
 
+namespace
+{
+    // Ordered against the order of the underlying values.
+    enum class Color : short { Red = -3, Green = 0, Blue = 5 };
+    bool operator<(Color color1, Color color2) { return static_cast<short>(color1) > static_cast<short>(color2); }
+
+    // Shares its name with an internal helper of the fused kernels, which must not take part in its lookup.
+    template <class T>
+    int Data(T const&) { return 1; }
+}
+
 TEST_CASE("numeric tests")
 {
     std::vector<int> ran = { 1, 2, 3, 4, 5 };
@@ -53,6 +75,295 @@ TEST_CASE("numeric tests")
         std::vector<std::complex<double>> vec = { 1.0 + 2.0i, 4.0 - 6.0i, -3.0 + 4.0i, -5.0, 2.0i };
         CHECK(From(vec).Average().real() == Approx(-0.6));
         CHECK(From(vec).Average().imag() == Approx(0.4));
+
+        auto const max = std::numeric_limits<double>::max();
+        CHECK(From(std::vector<double>{ max, max, -max }).Average() == Approx(max / 3));
+        CHECK(From(std::vector<std::complex<double>>{ 1e100, 1.0i, -1e100 }).Average().real() == 0);
+        CHECK(From(std::vector<std::complex<double>>{ 1e100, 1.0, -1e100 }).Average().real() == Approx(1.0 / 3));
+        CHECK(From(std::vector<std::complex<double>>{ max, max * 1.0i, max }).Average().real() == Approx(max * 2 / 3));
+
+        CHECK(From(ran).Average([](int i) { return i * i; }) == Approx(11));
+        CHECK(inp().Average([](int i) { return i * 0.5; }) == Approx(1.25));
+        CHECK(From(std::vector<float>{ 0.5f, 1.5f }).Average() == 1.0);
+
+        CHECK_THROWS_AS(From(std::vector<int>()).Average(), std::invalid_argument);
+        CHECK_THROWS_AS(From(std::vector<std::complex<double>>()).Average(), std::invalid_argument);
+    }
+
+    SECTION("ForEachBlock")
+    {
+        std::vector<int> large(1000);
+        std::iota(large.begin(), large.end(), 0);
+
+        auto blocks = [](auto const& enumerable)
+        {
+            std::vector<int> values;
+            size_t maxCount = 0;
+            enumerable.ForEachBlock([&](auto const* block, size_t count)
+            {
+                values.insert(values.end(), block, block + count);
+                maxCount = std::max(maxCount, count);
+            });
+
+            CHECK(maxCount <= 256);
+            return values;
+        };
+
+        CHECK(blocks(From(large)) == large);
+        CHECK(blocks(From(bid)) == std::vector<int>{ 6, 7, 8, 9 });
+        CHECK(blocks(inp()) == inp().ToVector());
+        CHECK(blocks(Enumerable::Range(0, 1000)) == large);
+
+        auto pipeline = From(large).Where([](int i) { return i % 3 == 0; }).Select([](int i) { return i / 3; }).Concat(bid);
+        CHECK(blocks(pipeline) == Enumerable::Range(0, 334).Concat(bid).ToVector());
+        CHECK(pipeline.Count() == 338);
+        CHECK(pipeline.Sum() == 333 * 334 / 2 + 30);
+
+        auto zipped = From(large).Zip(bid, [](int i, int j) { return i * j; });
+        CHECK(blocks(zipped) == std::vector<int>{ 0, 7, 16, 27 });
+        CHECK(Enumerable::Range(int64_t(0), int64_t(5)).Zip(large, [](int64_t i, int j) { return i + j; }).ToVector() == std::vector<int64_t>{ 0, 2, 4, 6, 8 });
+
+        size_t calls = 0;
+        CHECK(!From(large).ForEachBlock([&](auto const*, size_t) { return ++calls < 2; }));
+        CHECK(calls == 2);
+
+        CHECK(From(large).Where([](int i) { return i < 0; }).Count() == 0);
+        CHECK_THROWS_AS(From(large).Where([](int i) { return i < 0; }).Sum(), std::invalid_argument);
+        CHECK(From(std::vector<double>{ 0.5, 0.25 }).Select([](double d) { return 2 * d; }).Sum() == 1.5);
+    }
+
+    SECTION("OrderBy")
+    {
+        // Elements remember their positions, so that the order of equivalent elements is checked as well.
+        auto check = [](auto const& keys)
+        {
+            using Key = std::decay_t<decltype(keys[0])>;
+
+            std::vector<std::pair<Key, size_t>> values;
+            for (size_t i = 0; i < keys.size(); ++i)
+                values.emplace_back(keys[i], i);
+
+            auto ascending = values;
+            std::stable_sort(ascending.begin(), ascending.end(), [](auto const& value1, auto const& value2) { return value1.first < value2.first; });
+            auto descending = values;
+            std::stable_sort(descending.begin(), descending.end(), [](auto const& value1, auto const& value2) { return value1.first > value2.first; });
+
+            auto key = [](auto const& value) { return value.first; };
+            CHECK(From(values).OrderBy(key).SequenceEqual(ascending));
+            CHECK(From(values).OrderBy(key, std::less<Key>()).SequenceEqual(ascending));
+            CHECK(From(values).OrderByDescending(key).SequenceEqual(descending));
+            CHECK(From(values).OrderBy(key, std::greater<>()).SequenceEqual(descending));
+            CHECK(From(values).OrderBy(key, [](auto const& key1, auto const& key2) { return key1 < key2; }).SequenceEqual(ascending));
+
+            if (values.empty())
+                return;
+
+            auto sorted = From(values).OrderBy(key);
+            CHECK(sorted.ElementAt(values.size() / 2) == ascending[values.size() / 2]);
+            CHECK(sorted.First() == ascending.front());
+            CHECK(sorted.Last() == ascending.back());
+            CHECK(sorted.SequenceEqual(ascending));
+        };
+
+        std::vector<int> ints(20'000);
+        std::vector<int> smallInts(20'000);
+        std::vector<long long> timestamps(20'000);
+        std::vector<unsigned long long> unsigneds(5000);
+        std::vector<float> floats(5000);
+        std::vector<double> doubles(5000);
+        std::vector<signed char> chars(1000);
+        std::vector<bool> bools(1000);
+        for (size_t i = 0; i < ints.size(); ++i)
+        {
+            auto value = static_cast<long long>((i * 7919) % 20'011) - 10'000;
+            ints[i] = static_cast<int>(value * 99'991);
+            smallInts[i] = static_cast<int>(value % 100);
+            timestamps[i] = 1'600'000'000'000'000LL + value * value * 1'000'003;
+            if (i < unsigneds.size())
+                unsigneds[i] = static_cast<unsigned long long>(value) * 0x9E3779B97F4A7C15ULL;
+            if (i < floats.size())
+            {
+                floats[i] = static_cast<float>(value % 1000) / 8;
+                doubles[i] = static_cast<double>(value) * 1e300 / 7;
+            }
+            if (i < chars.size())
+            {
+                chars[i] = static_cast<signed char>(value);
+                bools[i] = value % 3 == 0;
+            }
+        }
+
+        ints[7] = std::numeric_limits<int>::min();
+        ints[8] = std::numeric_limits<int>::max();
+        unsigneds[9] = std::numeric_limits<unsigned long long>::max();
+        floats[10] = -0.0f;
+        floats[11] = std::numeric_limits<float>::infinity();
+        floats[12] = -std::numeric_limits<float>::infinity();
+        floats[13] = std::numeric_limits<float>::denorm_min();
+        doubles[14] = -0.0;
+
+        check(std::vector<int>());
+        check(std::vector<int>{ 3, -1, 2, -1, 0, 3 });
+        check(std::vector<int>(ints.begin(), ints.begin() + 200));
+        check(ints);
+        check(smallInts);
+        check(timestamps);
+        check(unsigneds);
+        check(floats);
+        check(doubles);
+        check(chars);
+        check(bools);
+        check(std::vector<short>(5000, 42));
+
+        std::vector<std::string> strings;
+        for (size_t i = 0; i < 1000; ++i)
+            strings.push_back(std::string((i * 7919) % 13, 'a') + std::to_string(i));
+
+        auto byLength = strings;
+        std::stable_sort(byLength.begin(), byLength.end(), [](auto const& s1, auto const& s2) { return s1.size() < s2.size(); });
+        CHECK(From(strings).OrderBy([](auto const& s) { return s.size(); }).SequenceEqual(byLength));
+
+        // Enums keep their own order.
+        std::vector<Color> colors;
+        for (size_t i = 0; i < 1000; ++i)
+            colors.push_back(i % 3 == 0 ? Color::Red : i % 3 == 1 ? Color::Blue : Color::Green);
+
+        auto identity = [](Color color) { return color; };
+        CHECK(From(colors).OrderBy(identity).Distinct().SequenceEqual(std::vector<Color>{ Color::Blue, Color::Green, Color::Red }));
+        CHECK(From(colors).OrderBy(identity, std::less<Color>()).Distinct().SequenceEqual(std::vector<Color>{ Color::Blue, Color::Green, Color::Red }));
+
+        // Large inputs are sorted in parallel, with the same results.
+        auto& pool = Yielding::WorkerPool::Instance();
+        auto concurrency = pool.Concurrency();
+        auto restore = Utility::on_exit([&] { pool.SetConcurrency(concurrency); });
+        pool.SetConcurrency(4);
+
+        std::vector<long long> manyTimestamps(100'000);
+        std::vector<int> manySmallInts(100'000);
+        std::vector<double> skewed(100'000);
+        for (size_t i = 0; i < manyTimestamps.size(); ++i)
+        {
+            auto value = static_cast<long long>((i * 7919) % 100'003);
+            manyTimestamps[i] = 1'600'000'000'000'000LL + value * value * 1'000'003;
+            manySmallInts[i] = static_cast<int>(value % 1000) - 500;
+            skewed[i] = i % 100 == 0 ? static_cast<double>(value) * 1e9 : static_cast<double>(value % 10);
+        }
+
+        check(manyTimestamps);
+        check(manySmallInts);
+        check(skewed);
+
+        std::vector<std::string> manyStrings;
+        for (auto value : manySmallInts)
+            manyStrings.push_back(std::to_string(value % 300));
+
+        check(manyStrings);
+
+        // Copies enumerated on several threads sort large segments, also in parallel, one thread at a time.
+        auto concurrently = [](auto const& sorted, auto const& expected)
+        {
+            std::vector<int> areSorted(4);
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < areSorted.size(); ++i)
+                threads.emplace_back([&, i] { areSorted[i] = sorted.SequenceEqual(expected); });
+            for (auto& thread : threads)
+                thread.join();
+
+            return From(areSorted).All([](int isSorted) { return isSorted != 0; });
+        };
+
+        auto sortedTimestamps = manyTimestamps;
+        std::sort(sortedTimestamps.begin(), sortedTimestamps.end());
+        auto timestamp = [](long long t) { return t; };
+        CHECK(concurrently(From(manyTimestamps).OrderBy(timestamp), sortedTimestamps));
+        CHECK(concurrently(From(manyTimestamps).OrderBy(timestamp, [](long long t1, long long t2) { return t1 < t2; }), sortedTimestamps));
+
+        auto lastDigit = [](int i) { return i % 10; };
+        auto rest = [](int i) { return i / 10; };
+        auto byDigits = manySmallInts;
+        std::stable_sort(byDigits.begin(), byDigits.end(), [&](int i1, int i2) { return lastDigit(i1) < lastDigit(i2) || (lastDigit(i1) == lastDigit(i2) && rest(i1) > rest(i2)); });
+        CHECK(From(manySmallInts).OrderBy(lastDigit).ThenByDescending(rest).SequenceEqual(byDigits));
+
+        // Only segments that are sorted completely are sorted in parallel, the first elements are still found by partitioning.
+        std::atomic<size_t> comparisons{0};
+        auto counting = [&](int i1, int i2) { ++comparisons; return i1 < i2; };
+        auto byValue = [](int i) { return i; };
+        CHECK(From(manySmallInts).OrderBy(byValue, counting).Take(1).SequenceEqual(std::vector<int>{ -500 }));
+        CHECK(comparisons < 4 * manySmallInts.size());
+
+        comparisons = 0;
+        CHECK(From(manySmallInts).OrderBy(byValue, counting).Count() == manySmallInts.size());
+        CHECK(comparisons == 0);
+    }
+
+    SECTION("Reductions")
+    {
+        std::vector<float> floats(1003);
+        for (size_t i = 0; i < floats.size(); ++i)
+            floats[i] = static_cast<float>((i * 37) % 101) - 50.5f;
+
+        double doubles[] = { 2.5, -1.0, 7.25, 0.0, 3.0 };
+        std::vector<short> shorts(100'000, 30'000);
+
+        CHECK(From(floats).Min() == -50.5f);
+        CHECK(From(floats).Max() == 49.5f);
+        CHECK(From(floats).MinMax() == std::make_pair(-50.5f, 49.5f));
+        CHECK(From(floats).Sum() == Approx(std::accumulate(floats.begin(), floats.end(), 0.0)));
+        CHECK(From(floats).Count([](float f) { return f > 0; }) == std::count_if(floats.begin(), floats.end(), [](float f) { return f > 0; }));
+
+        CHECK(From(doubles).Sum() == 11.75);
+        CHECK(From(doubles).MinMax() == std::make_pair(-1.0, 7.25));
+        CHECK(From(doubles).Count([](double d) { return d >= 2.5; }) == 3);
+
+        CHECK(From(shorts).SumWide() == 3'000'000'000LL);
+        CHECK(Enumerable::Range(0, 100'000).SumWide() == 4'999'950'000LL);
+        CHECK(From(std::vector<unsigned>(3, 4'000'000'000u)).SumWide() == 12'000'000'000ULL);
+        CHECK(From(shorts).SumWide([](short s) { return s / 2; }) == 1'500'000'000LL);
+        CHECK(From(doubles).SumWide() == 11.75);
+
+        static_assert(std::is_same<decltype(From(shorts).Sum()), short>::value, "Sum returns the element type.");
+        static_assert(std::is_same<decltype(From(shorts).SumWide()), std::int64_t>::value, "SumWide returns 64 bits.");
+        CHECK(From(shorts).Take(3).Sum() == 30'000 * 3 - 65'536);
+        CHECK(Enumerable::Range(0, 100).Sum() == 4950);
+
+        auto odd = Enumerable::Range(-500, 1001).Where([](int i) { return i % 2 != 0; });
+        CHECK(odd.MinMax() == std::make_pair(-499, 499));
+        CHECK(odd.Select([](int i) { return i * 0.5; }).Max() == 249.5);
+        CHECK(odd.Count([](int i) { return i > 0; }) == 250);
+        CHECK(From(bid).Min() == 6);
+
+        CHECK_THROWS_AS(From(std::vector<float>()).Min(), std::invalid_argument);
+        CHECK_THROWS_AS(From(std::vector<float>()).MinMax(), std::invalid_argument);
+        CHECK(From(std::vector<float>()).Count([](float) { return true; }) == 0);
+
+        std::vector<int> ints(floats.begin(), floats.end());
+        CHECK(From(floats).Zip(floats, std::multiplies<>()).Sum() == Approx(std::inner_product(floats.begin(), floats.end(), floats.begin(), 0.0)));
+        CHECK(From(ints).Zip(ran, std::multiplies<>()).Sum() == std::inner_product(ran.begin(), ran.end(), ints.begin(), 0LL));
+        CHECK(From(shorts).Zip(shorts, std::multiplies<int>()).SumWide() == 90'000'000'000'000LL);
+
+        std::vector<double> fractions = { 1.5, 2.5, 3.7 };
+        std::list<double> fractionList(fractions.begin(), fractions.end());
+        CHECK(From(fractions).Zip(fractions, std::multiplies<int>()).Sum() == 14);
+        CHECK(From(fractionList).Zip(fractionList, std::multiplies<int>()).Sum() == 14);
+        CHECK_THROWS_AS(From(ints).Zip(std::vector<int>(), std::multiplies<>()).Sum(), std::invalid_argument);
+        CHECK(Data(ran.begin()) == 1);
+
+        auto square = [](float f) { return f * f; };
+        CHECK(From(floats).Select(square).Sum() == Approx(std::inner_product(floats.begin(), floats.end(), floats.begin(), 0.0)));
+        CHECK(From(floats).Select(square).Max() == 50.5f * 50.5f);
+        CHECK(From(floats).Select(square).Average() == Approx(From(floats).Select(square).Sum() / floats.size()));
+        CHECK(From(doubles).Select([](double d) { return -d; }).MinMax() == std::make_pair(-7.25, 1.0));
+        CHECK_THROWS_AS(From(std::vector<float>()).Select(square).Sum(), std::invalid_argument);
+
+        std::vector<float> saxpy;
+        std::transform(floats.begin(), floats.end(), std::back_inserter(saxpy), [](float f) { return 2 * f + 1; });
+        CHECK(From(floats).Select([](float f) { return 2 * f + 1; }).ToVector() == saxpy);
+        std::vector<double> halves;
+        for (int i : ints)
+            halves.push_back(i / 2.0);
+        CHECK(From(ints).Select([](int i) { return i / 2.0; }).ToVector() == halves);
+        CHECK(From(std::vector<float>()).Select(square).ToVector().empty());
+        CHECK(From(doubles).Select([](double d) { return d < 1; }).ToVector() == std::vector<bool>{ false, true, false, true, false });
     }
 
     SECTION("Sum")
@@ -74,4 +385,43 @@ TEST_CASE("numeric tests")
         CHECK(From(vec).Sum().real() == Approx(-3.0));
         CHECK(From(vec).Sum().imag() == Approx(2.0));
     }
+
+    SECTION("Where")
+    {
+        auto check = [](auto const& values, auto predicate)
+        {
+            std::vector<std::decay_t<decltype(values[0])>> expected;
+            std::copy_if(values.begin(), values.end(), std::back_inserter(expected), predicate);
+
+            CHECK(From(values).Where(predicate).ToVector() == expected);
+            CHECK(From(values).Where(predicate).Count() == expected.size());
+        };
+
+        std::vector<float> floats(1003);
+        std::vector<double> doubles(777);
+        std::vector<long long> longs(300);
+        std::vector<short> shorts(500);
+        for (size_t i = 0; i < 1003; ++i)
+        {
+            auto value = static_cast<int>((i * 7919) % 1000) - 500;
+            floats[i] = value / 4.0f;
+            if (i < doubles.size())
+                doubles[i] = -value / 8.0;
+            if (i < longs.size())
+                longs[i] = value * 1'000'000'000LL;
+            if (i < shorts.size())
+                shorts[i] = static_cast<short>(value);
+        }
+
+        for (int threshold : { -600, -499, -100, 0, 250, 499, 600 })
+        {
+            check(floats, [=](float f) { return f * 4 < threshold; });
+            check(doubles, [=](double d) { return d * 8 >= threshold; });
+            check(longs, [=](long long l) { return l / 1'000'000'000LL > threshold; });
+            check(shorts, [=](short s) { return s <= threshold; });
+        }
+
+        check(floats, [](float f) { return static_cast<int>(f * 4) % 2 == 0; });
+        check(std::vector<int>(31, 1), [](int i) { return i == 1; });
+    }
 }
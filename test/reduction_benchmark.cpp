@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Linqpp.hpp"
+
+using namespace Linqpp;
+
+namespace
+{
+    template <class Function>
+    void Measure(std::string const& name, size_t n, Function function)
+    {
+        double checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            checksum += function();
+        std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": " << duration.count() / n << " us per run (" << checksum << ")" << std::endl;
+    }
+}
+
+int main()
+{
+    std::vector<float> floats(1'000'000);
+    for (size_t i = 0; i < floats.size(); ++i)
+        floats[i] = static_cast<float>((i * 7919) % 1000) / 8;
+
+    std::vector<int> ints(floats.begin(), floats.end());
+
+    // The scalar versions are what Sum, Max and Count(predicate) did before, element by element.
+    Measure("scalar sum of 1M floats", 200, [&] { return std::accumulate(floats.begin() + 1, floats.end(), floats.front()); });
+    Measure("Sum of 1M floats", 200, [&] { return From(floats).Sum(); });
+
+    Measure("scalar sum of 1M ints", 200, [&] { return std::accumulate(ints.begin(), ints.end(), 0LL); });
+    Measure("Sum of 1M ints", 200, [&] { return From(ints).Sum(); });
+
+    Measure("scalar max of 1M floats", 200, [&] { return *std::max_element(floats.begin(), floats.end()); });
+    Measure("Max of 1M floats", 200, [&] { return From(floats).Max(); });
+
+    Measure("scalar min and max of 1M floats", 200, [&] { auto p = std::minmax_element(floats.begin(), floats.end()); return *p.first + *p.second; });
+    Measure("MinMax of 1M floats", 200, [&] { auto p = From(floats).MinMax(); return p.first + p.second; });
+
+    Measure("scalar count of 1M floats", 200, [&] { return std::count_if(floats.begin(), floats.end(), [](float f) { return f > 60; }); });
+    Measure("Count of 1M floats", 200, [&] { return From(floats).Count([](float f) { return f > 60; }); });
+
+    Measure("scalar dot product of 1M floats", 200, [&] { return std::inner_product(floats.begin(), floats.end(), floats.begin(), 0.0f); });
+    Measure("Zip(multiplies).Sum() of 1M floats", 200, [&] { return From(floats).Zip(floats, std::multiplies<>()).Sum(); });
+
+    Measure("Select(square).Sum() of 1M floats", 200, [&] { return From(floats).Select([](float f) { return f * f + 1; }).Sum(); });
+
+    Measure("Select(saxpy).ToVector() of 1M floats", 200, [&] { return From(floats).Select([](float f) { return 2 * f + 1; }).ToVector().back(); });
+}
@@ -27,6 +27,9 @@ auto inp = []
     END_YIELDING
 };
 
+// Input iterators whose elements live in the iterators themselves.
+auto words = [](std::istream& stream) { return From(std::istream_iterator<std::string>(stream), std::istream_iterator<std::string>()); };
+
 std::vector<test_t> u = { 1, 1, 2, 3, 3, 1, 2, 3, 4 };
 std::vector<A> va = { A{1}, A{3}, A{3}, A{1} };
 std::vector<B> vb = { B{2}, B{4}, B{1}, B{2}, B{1} };
@@ -88,6 +91,36 @@ SECTION("Any")
     CHECK_FALSE(From(inp()).Any([](auto i) { return i > 10; }));
 }
 
+SECTION("AsEnumerable")
+{
+    static_assert(!std::is_polymorphic<decltype(From(ran))>::value, "Enumerables are not supposed to need a vtable.");
+
+    auto erased = From(ran).Where([](auto v) { return v > test_t(2); }).AsEnumerable();
+    IEnumerable<decltype(erased.begin())> const& base = erased;
+
+    CHECK(std::is_polymorphic<decltype(erased)>::value);
+    CHECK(base.SequenceEqual(std::vector<test_t>{ 3, 4, 5 }));
+    CHECK(base.Select([](auto v) { return v + test_t(1); }).SequenceEqual(std::vector<test_t>{ 4, 5, 6 }));
+    CHECK(&From(base) == &base);
+    CHECK(base.AsEnumerable().Count() == 3);
+
+    auto owning = From(bid).ToVector().AsEnumerable();
+    CHECK(owning.SequenceEqual(bid));
+    CHECK(From(inp()).AsEnumerable().Count() == 8);
+
+    // Code taking IEnumerable<Iterator> const& used to accept any enumerable. Such enumerables are erased explicitly now,
+    // or the code becomes a template over the enumerable type.
+    using Iterator = std::vector<test_t>::iterator;
+    static_assert(!std::is_convertible<decltype(From(ran)) const&, IEnumerable<Iterator> const&>::value, "Only erased enumerables implement the interface.");
+
+    auto countErased = [](IEnumerable<Iterator> const& enumerable) { return enumerable.Count([](auto v) { return v > test_t(2); }); };
+    CHECK(countErased(From(ran).AsEnumerable()) == 3);
+
+    auto countStatic = [](auto const& enumerable) { return enumerable.Count([](auto v) { return v > test_t(2); }); };
+    CHECK(countStatic(From(ran)) == 3);
+    CHECK(countStatic(From(ran).AsEnumerable()) == 3);
+}
+
 SECTION("Concat")
 {
     CHECK(From(ran).Concat(ran).SequenceEqual(std::vector<test_t>{1, 2, 3, 4, 5, 1, 2, 3, 4, 5}));
@@ -281,6 +314,9 @@ SECTION("First")
     CHECK(From(bid).First([](auto i){ return static_cast<int>(i) % 2 == 1; }) == 7);
     CHECK(From(forw).First([](auto i){ return i > 4; }) == 5);
     CHECK(From(inp()).First([](auto i){ return i > 0; }) == 1);
+
+    std::istringstream text("pear apple zucchini fig");
+    CHECK(words(text).First([](auto const& s) { return s[0] > 'q'; }) == "zucchini");
 }
 
 SECTION("FirstOrDefault")
@@ -304,6 +340,71 @@ SECTION("FirstOrDefault")
     CHECK(From(bid).FirstOrDefault([](auto i){ return i < 1; }) == 0);
     CHECK(From(forw).FirstOrDefault([](auto i){ return i < 1; }) == 0);
     CHECK(From(inp()).FirstOrDefault([](auto i){ return i > 10; }) == 0);
+
+    std::istringstream text("pear apple zucchini fig");
+    CHECK(words(text).FirstOrDefault([](auto const& s) { return s[0] < 'f'; }) == "apple");
+    std::istringstream noMatch("pear apple");
+    CHECK(words(noMatch).FirstOrDefault([](auto const& s) { return s[0] > 'q'; }) == "");
+}
+
+SECTION("ForEach")
+{
+    std::vector<test_t> visited;
+    CHECK(From(ran).ForEach([&](auto const& v) { visited.push_back(v); }));
+    CHECK(From(visited).SequenceEqual(ran));
+
+    visited.clear();
+    CHECK_FALSE(From(bid).Concat(forw).Where([](auto v) { return v > test_t(6); }).ForEach([&](auto const& v)
+    {
+        visited.push_back(v);
+        return visited.size() < 3;
+    }));
+    CHECK(From(visited).SequenceEqual(std::vector<test_t>{ 7, 8, 9 }));
+
+    int calls = 0;
+    CHECK(From(forw).Select([](auto v) { return v + test_t(1); }).Any([&](auto v) { ++calls; return v == test_t(5); }));
+    CHECK(calls == 2);
+
+    calls = 0;
+    auto counting = Enumerable::Generate(0, [&](int& state) { ++calls; return test_t(state++); });
+    CHECK(counting.Take(3).Sum() == test_t(3));
+    CHECK(calls == 3);
+
+    CHECK(From(bid).Skip(2).Sum() == test_t(17));
+    CHECK(From(forw).SkipWhile([](auto v) { return v < test_t(5); }).Sum() == test_t(18));
+    CHECK(From(inp()).Where([](auto v) { return v > test_t(3); }).Count() == 3);
+
+    CHECK_THROWS_AS(Enumerable::Empty<test_t>().Sum(), std::invalid_argument);
+    CHECK_THROWS_AS(Enumerable::Empty<test_t>().Max(), std::invalid_argument);
+    CHECK_THROWS_AS(From(ran).First([](auto v) { return v > test_t(10); }), std::invalid_argument);
+}
+
+SECTION("Generate")
+{
+    auto fibonacci = Enumerable::Generate(std::make_pair(0, 1), [](auto& state)
+    {
+        auto value = state.first;
+        state = std::make_pair(state.second, state.first + state.second);
+        return test_t(value);
+    });
+
+    CHECK(fibonacci.Take(8).SequenceEqual(std::vector<test_t>{ 0, 1, 1, 2, 3, 5, 8, 13 }));
+    CHECK(fibonacci.ElementAt(10) == test_t(55));
+    CHECK(fibonacci.First() == test_t(0));
+}
+
+SECTION("Iterate")
+{
+    auto powers = Enumerable::Iterate(test_t(1), [](test_t t) { return t + t; });
+
+    CHECK(powers.Take(5).SequenceEqual(std::vector<test_t>{ 1, 2, 4, 8, 16 }));
+    CHECK(powers.First() == test_t(1));
+
+    int calls = 0;
+    auto counted = Enumerable::Iterate(0, [&](int i) { ++calls; return i + 1; });
+    CHECK(calls == 0);
+    CHECK(counted.ElementAt(3) == 3);
+    CHECK(calls == 3);
 }
 
 SECTION("Last")
@@ -353,6 +454,24 @@ SECTION("Max")
     CHECK(From(bid).Max(std::negate<>()) == -6);
     CHECK(From(forw).Max(std::negate<>()) == -3);
     CHECK(From(inp()).Max(std::negate<>()) == 1);
+
+    std::istringstream text("pear apple zucchini fig");
+    CHECK(words(text).Max() == "zucchini");
+}
+
+SECTION("Memoize")
+{
+    auto mran = From(ran).Memoize();
+    CHECK(mran.SequenceEqual(ran));
+    CHECK(mran.SequenceEqual(ran));
+
+    auto minp = inp().Memoize();
+    CHECK(minp.Count() == 8);
+    CHECK(minp.SequenceEqual(inp()));
+    CHECK(minp.Zip(minp.Skip(1), [](auto a, auto b) { return a + test_t(1) == b; }).All([](bool b) { return b; }));
+    CHECK(From(minp).Skip(3).First() == test_t(2));
+
+    CHECK_FALSE(Enumerable::Empty<test_t>().Memoize().Any());
 }
 
 SECTION("Min")
@@ -366,6 +485,31 @@ SECTION("Min")
     CHECK(From(bid).Min(std::negate<>()) == -9);
     CHECK(From(forw).Min(std::negate<>()) == -7);
     CHECK(From(inp()).Min(std::negate<>()) == -6);
+
+    std::istringstream text("pear apple zucchini fig");
+    CHECK(words(text).Min() == "apple");
+}
+
+SECTION("MinMax")
+{
+    CHECK(From(ran).MinMax().first == 1);
+    CHECK(From(ran).MinMax().second == 5);
+    CHECK(From(bid).MinMax().first == 6);
+    CHECK(From(bid).MinMax().second == 9);
+    CHECK(From(forw).MinMax().first == 3);
+    CHECK(From(forw).MinMax().second == 7);
+    CHECK(From(inp()).MinMax().first == -1);
+    CHECK(From(inp()).MinMax().second == 6);
+
+    CHECK(From(ran).MinMax(std::negate<>()).first == -5);
+    CHECK(From(ran).MinMax(std::negate<>()).second == -1);
+    CHECK(From(inp()).Take(1).MinMax().first == -1);
+    CHECK(From(inp()).Take(1).MinMax().second == -1);
+
+    std::istringstream text("pear apple zucchini fig");
+    CHECK(words(text).MinMax() == std::make_pair(std::string("apple"), std::string("zucchini")));
+
+    CHECK_THROWS_AS(Enumerable::Empty<test_t>().MinMax(), std::invalid_argument);
 }
 
 SECTION("OrderBy")
@@ -387,6 +531,56 @@ SECTION("OrderBy")
     CHECK(From(bid).OrderByDescending([](auto a) { return a; }).SequenceEqual(From(bid).Reverse()));
     CHECK(From(forw).OrderByDescending([](auto a) { return a; }).SequenceEqual(From(forw).Reverse()));
     CHECK(From(inp()).OrderByDescending([](auto a) { return a; }).SequenceEqual(inp().Reverse()));
+
+    std::vector<test_t> shuffled;
+    for (int i = 0; i < 2000; ++i)
+        shuffled.push_back((i * 7919) % 2000);
+
+    size_t keys = 0;
+    auto sorted = From(shuffled).OrderBy([&](auto const& a) { ++keys; return static_cast<int>(a); });
+
+    CHECK(sorted.First() == 0);
+    CHECK(keys == shuffled.size());
+    CHECK(sorted.Take(5).SequenceEqual(Enumerable::Range(0, 5)));
+    CHECK(sorted.ElementAt(1500) == 1500);
+    CHECK(sorted.ElementAt(20) == 20);
+    CHECK(sorted.Skip(1990).SequenceEqual(Enumerable::Range(1990, 10)));
+    CHECK(sorted.SequenceEqual(Enumerable::Range(0, 2000)));
+    CHECK(keys == shuffled.size());
+    CHECK(From(shuffled).OrderByDescending([](auto a) { return a; }).First() == 1999);
+    CHECK(From(shuffled).OrderByDescending([](auto a) { return a; }).SequenceEqual(Enumerable::Range(0, 2000).Reverse()));
+    CHECK(From(shuffled).OrderBy([](auto a) { return static_cast<int>(a) / 100; }).Select([](auto a) { return static_cast<int>(a) / 100; })
+            .SequenceEqual(Enumerable::Range(0, 2000).Select([](int i) { return i / 100; })));
+
+    // Copies of a sorted sequence put elements in place on the threads that enumerate them.
+    std::vector<test_t> manyShuffled;
+    for (int i = 0; i < 50'000; ++i)
+        manyShuffled.push_back((i * 7919) % 50'000);
+
+    auto shared = From(manyShuffled).OrderBy([](auto const& a) { return static_cast<int>(a); }, [](int a1, int a2) { return a1 < a2; });
+    std::vector<int> areSorted(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < areSorted.size(); ++i)
+        threads.emplace_back([&, i] { areSorted[i] = shared.SequenceEqual(Enumerable::Range(0, 50'000)); });
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(From(areSorted).All([](int isSorted) { return isSorted != 0; }));
+
+    // Keys that refer to their elements are computed for each comparison.
+    struct Point { int x; int y; };
+    struct NamedPoint { int x; int y; std::string name; };
+    std::vector<Point> points = { {2, 1}, {1, 3}, {2, 0}, {1, 1}, {0, 5} };
+    std::vector<NamedPoint> namedPoints = { {2, 1, "a"}, {1, 3, "b"}, {2, 0, "c"}, {1, 1, "d"}, {0, 5, "e"} };
+    auto byXY = [](auto const& p) { return std::tie(p.x, p.y); };
+    auto toInt = [](auto const& p) { return 10 * p.x + p.y; };
+
+    CHECK(From(points).OrderBy(byXY).Select(toInt).SequenceEqual(std::vector<int>{ 5, 11, 13, 20, 21 }));
+    CHECK(From(points).OrderByDescending(byXY).Select(toInt).SequenceEqual(std::vector<int>{ 21, 20, 13, 11, 5 }));
+    CHECK(From(namedPoints).OrderBy(byXY).Select([](auto const& p) { return p.name; })
+            .SequenceEqual(std::vector<std::string>{ "e", "d", "b", "c", "a" }));
+    CHECK(From(namedPoints).OrderBy([](auto const& p) { return p.x; }).ThenByDescending(byXY).Select(toInt)
+            .SequenceEqual(std::vector<int>{ 5, 13, 11, 21, 20 }));
 }
 
 SECTION("Repeat")
@@ -433,6 +627,45 @@ SECTION("Select")
     CHECK(From(inp()).Select([](auto i) { return '\'' + to_string(i) + '\''; }).SequenceEqual(std::vector<std::string>{"'-1'", "'0'", "'1'", "'2'", "'3'", "'4'", "'5'", "'6'"}));
 }
 
+SECTION("SelectCached")
+{
+    using std::to_string;
+
+    size_t calls = 0;
+    auto quote = [&](auto i) { ++calls; return '\'' + to_string(i) + '\''; };
+    auto isShort = [](std::string const& s) { return s.size() == 3; };
+    auto pull = [](auto const& enumerable)
+    {
+        std::vector<std::string> result;
+        for (auto const& s : enumerable)
+            result.push_back(s);
+        return result;
+    };
+
+    CHECK(pull(From(ran).Select(quote).Where(isShort)) == std::vector<std::string>{"'1'", "'2'", "'3'", "'4'", "'5'"});
+    CHECK(calls == 2 * ran.size());
+
+    calls = 0;
+    CHECK(pull(From(ran).SelectCached(quote).Where(isShort)) == std::vector<std::string>{"'1'", "'2'", "'3'", "'4'", "'5'"});
+    CHECK(calls == ran.size());
+
+    calls = 0;
+    CHECK(pull(From(bid).SelectCached(quote).Where(isShort)) == std::vector<std::string>{"'6'", "'7'", "'8'", "'9'"});
+    CHECK(calls == bid.size());
+    CHECK(pull(From(bid).SelectCached(quote).Where(isShort).Reverse()) == std::vector<std::string>{"'9'", "'8'", "'7'", "'6'"});
+
+    calls = 0;
+    CHECK(pull(From(forw).SelectCached(quote).Where(isShort)) == std::vector<std::string>{"'3'", "'4'", "'5'", "'6'", "'7'"});
+    CHECK(calls == 5);
+
+    calls = 0;
+    CHECK(pull(From(inp()).SelectCached(quote).Where(isShort)) == std::vector<std::string>{"'0'", "'1'", "'2'", "'3'", "'4'", "'5'", "'6'"});
+    CHECK(calls == 8);
+
+    CHECK(From(ran).SelectCached([](auto i) { return i; }).SequenceEqual(ran));
+    CHECK(From(ran).SelectCached([](auto i) { return 2 * static_cast<int>(i); }).Sum() == 30);
+}
+
 SECTION("SequenceEqual")
 {
     CHECK_FALSE(From(ran).SequenceEqual(bid));
@@ -462,6 +695,35 @@ SECTION("SequenceEqual")
     CHECK(From(inp()).SequenceEqual(Enumerable::Range(-1, 8).StaticCast<test_t>()));
 }
 
+SECTION("SizeHint")
+{
+    auto isEven = [](auto i) { return static_cast<int>(i) % 2 == 0; };
+    auto unknown = std::numeric_limits<size_t>::max();
+
+    CHECK(From(ran).SizeHint() == 5);
+    CHECK(From(ran).Where(isEven).SizeHint() == 5);
+    CHECK(From(ran).Where(isEven).Select([](auto i) { return i; }).SizeHint() == 5);
+    CHECK(From(ran).Where(isEven).Concat(ran).SizeHint() == 10);
+    CHECK(From(ran).Where(isEven).Take(3).SizeHint() == 3);
+    CHECK(From(ran).Where(isEven).Zip(bid, [](auto i, auto) { return i; }).SizeHint() == 5);
+    CHECK(From(ran).Where(isEven).Reverse().SizeHint() == 5);
+    CHECK(From(ran).SkipWhile(isEven).SizeHint() == 5);
+    CHECK(From(ran).Distinct().SizeHint() == 5);
+    CHECK(From(u).Where(isEven).Where(isEven).SizeHint() == u.size());
+
+    CHECK(From(bid).SizeHint() == unknown);
+    CHECK(From(bid).Take(3).SizeHint() == 3);
+    CHECK(From(forw).Where(isEven).Take(3).SizeHint() == 3);
+    CHECK(From(inp()).SizeHint() == unknown);
+    CHECK(From(inp()).Take(2).SizeHint() == 2);
+    CHECK(From(bid).ToSet().SizeHint() == 4);
+
+    CHECK(From(ran).Where(isEven).Skip(2).SizeHint() == 3);
+    CHECK(From(ran).Where(isEven).Skip(7).SizeHint() == 0);
+    CHECK(From(bid).Take(3).Skip(1).SizeHint() == 2);
+    CHECK(From(forw).Where(isEven).Take(3).Skip(1).SizeHint() == 2);
+}
+
 SECTION("Skip")
 {
     CHECK(From(ran).Skip(3).Count() == ran.size() - 3);
@@ -515,6 +777,55 @@ SECTION("Take")
     CHECK(From(inp()).Take(10).Count() == inp().Count());
 }
 
+SECTION("ThenBy")
+{
+    std::vector<test_t> shuffled;
+    for (int i = 0; i < 60; ++i)
+        shuffled.push_back((i * 37) % 60);
+
+    auto identity = [](auto a) { return static_cast<int>(a); };
+    auto byTwo = [](auto a) { return static_cast<int>(a) % 2; };
+    auto byThree = [](auto a) { return static_cast<int>(a) % 3; };
+    auto byFive = [](auto a) { return static_cast<int>(a) % 5; };
+
+    auto expected = [](auto less)
+    {
+        std::vector<int> values(60);
+        std::iota(values.begin(), values.end(), 0);
+        std::sort(values.begin(), values.end(), less);
+        return values;
+    };
+
+    CHECK(From(shuffled).OrderBy(byThree).ThenBy(byFive).ThenBy(identity).Select(identity)
+            .SequenceEqual(expected([](int a, int b) { return std::make_tuple(a % 3, a % 5, a) < std::make_tuple(b % 3, b % 5, b); })));
+    CHECK(From(shuffled).OrderBy(byThree).ThenByDescending(byFive).ThenByDescending(identity).Select(identity)
+            .SequenceEqual(expected([](int a, int b) { return std::make_tuple(a % 3, -(a % 5), -a) < std::make_tuple(b % 3, -(b % 5), -b); })));
+    CHECK(From(shuffled).OrderByDescending(byThree).ThenBy(identity, std::greater<>()).Select(identity)
+            .SequenceEqual(expected([](int a, int b) { return std::make_tuple(-(a % 3), -a) < std::make_tuple(-(b % 3), -b); })));
+    CHECK(From(shuffled).OrderBy(byFive).ThenByDescending(identity, std::greater<>()).Select(identity)
+            .SequenceEqual(expected([](int a, int b) { return std::make_tuple(a % 5, a) < std::make_tuple(b % 5, b); })));
+
+    CHECK(From(ran).OrderBy(byTwo).ThenByDescending(identity).SequenceEqual(std::vector<test_t>{4, 2, 5, 3, 1}));
+    CHECK(From(bid).OrderByDescending(byTwo).ThenBy(identity).SequenceEqual(std::vector<test_t>{7, 9, 6, 8}));
+    CHECK(From(forw).OrderBy(byTwo).ThenBy(identity).SequenceEqual(std::vector<test_t>{4, 6, 3, 5, 7}));
+    CHECK(From(inp()).OrderBy([](auto a) { return a < 2; }).ThenByDescending(identity).SequenceEqual(std::vector<test_t>{6, 5, 4, 3, 2, 1, 0, -1}));
+
+    CHECK(From(va).OrderBy([](auto const& a) { return a.a; }).ThenBy([](auto const&) { return 0; }).Select([](auto const& a) { return a.a; })
+            .SequenceEqual(std::vector<test_t>{1, 1, 3, 3}));
+
+    size_t keys1 = 0, keys2 = 0, keys3 = 0;
+    auto sorted = From(shuffled)
+        .OrderBy([&](auto a) { ++keys1; return static_cast<int>(a) % 2; })
+        .ThenBy([&](auto a) { ++keys2; return static_cast<int>(a) % 7; })
+        .ThenBy([&](auto a) { ++keys3; return static_cast<int>(a); });
+
+    CHECK(sorted.First() == 0);
+    CHECK(sorted.SequenceEqual(expected([](int a, int b) { return std::make_tuple(a % 2, a % 7, a) < std::make_tuple(b % 2, b % 7, b); })));
+    CHECK(keys1 == shuffled.size());
+    CHECK(keys2 == shuffled.size());
+    CHECK(keys3 == shuffled.size());
+}
+
 SECTION("ToMap")
 {
     SECTION("KeySelector")
@@ -657,6 +968,72 @@ SECTION("ToVector")
     CHECK(From(bid).ToVector().SequenceEqual(vbid));
     CHECK(From(forw).ToVector().SequenceEqual(vforw));
     CHECK(From(inp()).ToVector().SequenceEqual(vinp));
+
+    CHECK(From(bid).ToVector(4).SequenceEqual(vbid));
+    CHECK(From(bid).ToVector(4).capacity() == 4);
+    CHECK(From(bid).ToVector(100).SequenceEqual(vbid));
+    CHECK(From(bid).ToVector(100).capacity() < 100);
+    CHECK(From(inp()).ToVector(2).SequenceEqual(vinp));
+    CHECK(From(ran).ToSet().ToVector().capacity() == 5);
+    CHECK(From(ran).Where([](auto i) { return static_cast<int>(i) % 2 == 0; }).ToVector().capacity() <= ran.size());
+    CHECK(From(ran).Concat(bid).ToVector(9).capacity() == 9);
+}
+
+SECTION("TryGetSize")
+{
+    auto isEven = [](auto i) { return static_cast<int>(i) % 2 == 0; };
+    size_t size = 42;
+
+    CHECK(From(ran).TryGetSize(size));
+    CHECK(size == 5);
+    CHECK(From(ran).Select([](auto i) { return i; }).Concat(ran).Skip(2).TryGetSize(size));
+    CHECK(size == 8);
+    CHECK(From(ran).Zip(Enumerable::Range(int64_t(0), int64_t(3)), [](auto i, auto) { return i; }).Take(10).TryGetSize(size));
+    CHECK(size == 3);
+    CHECK(From(ran).Reverse().TryGetSize(size));
+    CHECK(size == 5);
+    CHECK(From(bid).ToSet().TryGetSize(size));
+    CHECK(size == 4);
+    CHECK(From(bid).ToSet().Count() == 4);
+
+    size = 42;
+    CHECK(!From(ran).Where(isEven).TryGetSize(size));
+    CHECK(!From(ran).Distinct().TryGetSize(size));
+    CHECK(!From(bid).TryGetSize(size));
+    CHECK(!From(forw).Take(2).TryGetSize(size));
+    CHECK(!From(inp()).TryGetSize(size));
+    CHECK(size == 42);
+
+    CHECK(From(ran).Where(isEven).ElementAtOrDefault(5) == 0);
+    CHECK(From(ran).Where(isEven).ElementAtOrDefault(1) == 4);
+    CHECK(From(ran).Where(isEven).Take(1).ElementAtOrDefault(1) == 0);
+}
+
+SECTION("Unfold")
+{
+    auto countdown = Enumerable::Unfold(3, [](int& state) -> Utility::Optional<test_t>
+    {
+        if (state == 0)
+            return {};
+        return test_t(state--);
+    });
+
+    CHECK(countdown.SequenceEqual(std::vector<test_t>{ 3, 2, 1 }));
+    CHECK(countdown.Count() == 3);
+    CHECK(countdown.Reverse().SequenceEqual(std::vector<test_t>{ 1, 2, 3 }));
+
+    auto empty = Enumerable::Unfold(0, [](int&) { return Utility::Optional<test_t>(); });
+    CHECK_FALSE(empty.Any());
+
+    auto it = countdown.begin();
+    auto copy = it;
+    CHECK(it == copy);
+    ++it;
+    CHECK(it != copy);
+    CHECK(*copy == test_t(3));
+    CHECK(*it == test_t(2));
+    copy = it;
+    CHECK(it == copy);
 }
 
 SECTION("Union")
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Linqpp.hpp"
+
+using namespace Linqpp;
+
+namespace
+{
+    auto ShortFunction()
+    {
+        START_YIELDING(int)
+        for (int i = 0; i < 10; ++i)
+            yield_return(i);
+        END_YIELDING
+    }
+
+    auto LongFunction(size_t batchSize)
+    {
+        START_YIELDING_BATCHED(int, batchSize)
+        for (int i = 0; i < 200'000; ++i)
+            yield_return(i);
+        END_YIELDING
+    }
+
+    template <class Function>
+    void MeasureValues(std::string const& name, size_t n, Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": " << duration.count() / n << " ns per value" << std::endl;
+    }
+
+    template <class Function>
+    void Measure(std::string const& name, size_t n, Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            function();
+        std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << name << ": " << duration.count() / n << " us per generator" << std::endl;
+    }
+}
+
+int main()
+{
+    constexpr size_t n = 5'000;
+    auto& pool = Yielding::WorkerPool::Instance();
+
+    pool.SetSize(0);
+    Measure("spawn per generator", n, [] { return ShortFunction().Sum(); });
+
+    pool.SetSize(4);
+    pool.SetStackSize(64 * 1024);
+    Measure("worker pool", n, [] { return ShortFunction().Sum(); });
+
+    MeasureValues("unbatched", 200'000, [] { return LongFunction(1).Count(); });
+    MeasureValues("batches of 256", 200'000, [] { return LongFunction(256).Count(); });
+}
@@ -0,0 +1,226 @@
+#define LINQPP_YIELD_CONTEXT
+
+#include <exception>
+#include <forward_list>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Linqpp.hpp"
+#include "catch.hpp"
+
+typedef int test_t;
+
+namespace
+{
+    auto CallerThreadIds()
+    {
+        START_YIELDING_CONTEXT(std::thread::id)
+        for (int i = 0; i < 3; ++i)
+            yield_return(std::this_thread::get_id());
+        END_YIELDING
+    }
+
+    int Recurse(int depth) { return depth == 0 ? 0 : 1 + Recurse(depth - 1); }
+
+    auto DeepFunction(int depth)
+    {
+        START_YIELDING_CONTEXT(int)
+        yield_return(Recurse(depth));
+        END_YIELDING
+    }
+
+    auto InfiniteFunction(std::shared_ptr<int> spOffset)
+    {
+        START_YIELDING_CONTEXT(int)
+        for (int i = 0; ; ++i)
+            yield_return(i + *spOffset);
+        END_YIELDING
+    }
+
+    auto HugeContextFunction()
+    {
+        START_YIELDING_CONTEXT(std::string)
+        for (int i = 0; i < 1'000'000; ++i)
+            yield_return(std::to_string(i));
+        END_YIELDING
+    }
+
+    auto DelegatingFunction(std::vector<int> values)
+    {
+        START_YIELDING_CONTEXT(int)
+        yield_return(-1);
+        yield_from(values);
+        yield_from(std::vector<int>());
+        yield_from(Linqpp::Enumerable::Range(10, 3));
+        yield_return(-2);
+        END_YIELDING
+    }
+
+    auto BreakingFunction(int n)
+    {
+        START_YIELDING_CONTEXT(int)
+        for (int i = 0; ; ++i)
+        {
+            if (i == n)
+                yield_break;
+            yield_return(i);
+        }
+        END_YIELDING
+    }
+}
+
+TEST_CASE("yield_return context test")
+{
+    SECTION("Runs on calling thread")
+    {
+        auto id = std::this_thread::get_id();
+        CHECK(CallerThreadIds().All([=](auto i) { return i == id; }));
+
+        // Functions that start with START_YIELDING keep their thread.
+        auto f1 = []
+        {
+            START_YIELDING(std::thread::id)
+            yield_return(std::this_thread::get_id());
+            END_YIELDING
+        };
+
+        CHECK(f1().First() != id);
+    }
+
+    SECTION("Own stack")
+    {
+        CHECK(DeepFunction(1000).First() == 1000);
+    }
+
+    SECTION("Many values")
+    {
+        CHECK(HugeContextFunction().Count() == 1'000'000);
+        CHECK(HugeContextFunction().First() == "0");
+    }
+
+    SECTION("Move only values")
+    {
+        auto f1 = []
+        {
+            START_YIELDING_CONTEXT(std::unique_ptr<int>)
+            for (int i = 0; i < 10; ++i)
+                yield_return(std::make_unique<int>(i));
+            END_YIELDING
+        };
+
+        CHECK(f1().Select([](auto sp) { return *sp; }).SequenceEqual(Linqpp::Enumerable::Range(0, 10)));
+    }
+
+    SECTION("Cancellation")
+    {
+        auto spOffset = std::make_shared<int>(0);
+        std::weak_ptr<int> wpOffset = spOffset;
+
+        CHECK(InfiniteFunction(spOffset).Take(3).SequenceEqual(std::vector<int>{ 0, 1, 2 }));
+        CHECK(InfiniteFunction(spOffset).Skip(10).First() == 10);
+
+        spOffset.reset();
+        CHECK(wpOffset.expired());
+
+        auto swallowing = [](std::shared_ptr<int> spOffset)
+        {
+            START_YIELDING_CONTEXT(int)
+            for (int i = 0; i < 100; ++i)
+            {
+                try
+                {
+                    yield_return(i + *spOffset);
+                }
+                catch (...)
+                {
+                }
+            }
+            END_YIELDING
+        };
+
+        spOffset = std::make_shared<int>(0);
+        wpOffset = spOffset;
+
+        CHECK(swallowing(spOffset).First() == 0);
+
+        spOffset.reset();
+        CHECK(wpOffset.expired());
+    }
+
+    SECTION("yield_from")
+    {
+        CHECK(DelegatingFunction({ 1, 2, 3 }).SequenceEqual(std::vector<int>{ -1, 1, 2, 3, 10, 11, 12, -2 }));
+        CHECK(DelegatingFunction({}).SequenceEqual(std::vector<int>{ -1, 10, 11, 12, -2 }));
+        CHECK(DelegatingFunction({ 1, 2, 3 }).ElementAt(2) == 2);
+    }
+
+    SECTION("yield_break")
+    {
+        CHECK(!BreakingFunction(0).Any());
+        CHECK(BreakingFunction(5).SequenceEqual(Linqpp::Enumerable::Range(0, 5)));
+    }
+
+    SECTION("Statistics")
+    {
+        auto deep = DeepFunction(10);
+        auto spStatistics = deep.EnableStatistics();
+        CHECK(deep.Count() == 1);
+
+        CHECK(spStatistics->Values() == 1);
+        CHECK(spStatistics->Handoffs() == 2);
+        CHECK(Linqpp::From(spStatistics->LatencyHistogram()).Sum() == 2);
+    }
+
+    SECTION("Exception")
+    {
+        auto f1 = []
+        {
+            START_YIELDING_CONTEXT(int)
+            yield_return(1);
+            throw 3;
+            END_YIELDING
+        };
+
+        CHECK(f1().First() == 1);
+        CHECK_THROWS_AS(f1().Count(), int);
+
+        // Cancelling the function from within another handler keeps that handler's exception.
+        auto spF1 = std::make_unique<decltype(f1())>(f1());
+        int rethrown = 0;
+        try
+        {
+            spF1->Count();
+        }
+        catch (int)
+        {
+            try
+            {
+                throw 5;
+            }
+            catch (int)
+            {
+                spF1.reset();
+                try
+                {
+                    throw;
+                }
+                catch (int i)
+                {
+                    rethrown = i;
+                }
+            }
+        }
+
+        CHECK(rethrown == 5);
+        CHECK(std::current_exception() == nullptr);
+    }
+
+    // The shared tests run on the context backend as well.
+    #undef START_YIELDING
+    #define START_YIELDING START_YIELDING_CONTEXT
+    #include "test_template.hpp"
+}
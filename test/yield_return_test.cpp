@@ -1,4 +1,8 @@
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <set>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include <utility>
@@ -79,6 +83,83 @@ auto HugeFunction()
     END_YIELDING
 }
 
+auto ThreadIdFunction()
+{
+    START_YIELDING(std::thread::id)
+    yield_return(std::this_thread::get_id());
+    END_YIELDING
+}
+
+auto BatchedFunction(int n, std::shared_ptr<std::atomic<int>> spProduced = std::make_shared<std::atomic<int>>())
+{
+    START_YIELDING_BATCHED(int, 16)
+    for (int i = 0; i < n; ++i)
+    {
+        ++*spProduced;
+        yield_return(i);
+    }
+    END_YIELDING
+}
+
+auto CountingFunction(int n, std::shared_ptr<std::atomic<int>> spProduced = std::make_shared<std::atomic<int>>())
+{
+    START_YIELDING(int)
+    for (int i = 0; i < n; ++i)
+    {
+        ++*spProduced;
+        yield_return(i);
+    }
+    END_YIELDING
+}
+
+auto InfiniteFunction(std::shared_ptr<int> spOffset)
+{
+    START_YIELDING(int)
+    for (int i = 0; ; ++i)
+        yield_return(i + *spOffset);
+    END_YIELDING
+}
+
+auto DelegatingFunction(std::vector<int> values)
+{
+    START_YIELDING(int)
+    yield_return(-1);
+    yield_from(values);
+    yield_from(std::vector<int>());
+    yield_from(Enumerable::Range(10, 3));
+    yield_return(-2);
+    END_YIELDING
+}
+
+auto BreakingFunction(int n)
+{
+    START_YIELDING(int)
+    for (int i = 0; ; ++i)
+    {
+        if (i == n)
+            yield_break;
+        yield_return(i);
+    }
+    END_YIELDING
+}
+
+auto SwallowingFunction(std::shared_ptr<std::atomic<int>> spReturned)
+{
+    START_YIELDING(int)
+    auto returned = Utility::on_exit([=] { ++*spReturned; });
+    for (int i = 0; i < 100; ++i)
+    {
+        try
+        {
+            yield_return(i);
+        }
+        catch (...)
+        {
+        }
+    }
+    END_YIELDING
+}
+
 template <class T>
 auto TemplateFunction()
 {
@@ -229,4 +310,166 @@ TEST_CASE("yield_return tests")
 
         CHECK_THROWS_AS(ff.Count(), int);
     }
+
+    SECTION("Worker pool")
+    {
+        auto& pool = Yielding::WorkerPool::Instance();
+        auto size = pool.Size();
+        auto restore = Utility::on_exit([&] { pool.SetSize(size); pool.SetStackSize(0); });
+
+        pool.SetSize(2);
+        pool.SetStackSize(64 * 1024);
+
+        std::set<std::thread::id> ids;
+        for (int i = 0; i < 100; ++i)
+            ids.insert(ThreadIdFunction().Last());
+
+        CHECK(ids.size() < 100);
+        CHECK(ids.count(std::this_thread::get_id()) == 0);
+
+        pool.SetSize(0);
+        CHECK(MultipleFunction().Count() == 100);
+        CHECK(MultipleFunction().Last() == 99);
+    }
+
+    SECTION("Batched")
+    {
+        CHECK(!BatchedFunction(0).Any());
+        CHECK(BatchedFunction(1).SequenceEqual(Enumerable::Range(0, 1)));
+        CHECK(BatchedFunction(16).SequenceEqual(Enumerable::Range(0, 16)));
+        CHECK(BatchedFunction(100).SequenceEqual(Enumerable::Range(0, 100)));
+        CHECK(BatchedFunction(1'000'000).Count() == 1'000'000);
+        CHECK(BatchedFunction(100).Skip(20).Take(40).Last() == 59);
+
+        auto spProduced = std::make_shared<std::atomic<int>>(0);
+        auto batched = BatchedFunction(100, spProduced);
+        auto first = batched.begin();
+        CHECK(*first == 0);
+        CHECK(*spProduced == 16);
+
+        auto f1 = []
+        {
+            START_YIELDING_BATCHED(int, 8)
+            yield_return(1);
+            yield_return(2);
+            throw 3;
+            END_YIELDING
+        };
+
+        CHECK(f1().ElementAt(1) == 2);
+        CHECK_THROWS_AS(f1().Count(), int);
+    }
+
+    SECTION("Memoize")
+    {
+        auto spProduced = std::make_shared<std::atomic<int>>(0);
+        auto memoized = CountingFunction(100, spProduced).Memoize();
+        CHECK(*spProduced == 0);
+        CHECK(memoized.ElementAt(4) == 4);
+        CHECK(memoized.First() == 0);
+        CHECK(*spProduced == 5);
+        CHECK(memoized.Average() == Approx(49.5));
+        CHECK(memoized.Count() == 100);
+        CHECK(*spProduced == 100);
+
+        auto concurrent = CountingFunction(10'000).Memoize();
+        std::vector<int> sums(4);
+        std::vector<std::thread> threads;
+        for (auto& sum : sums)
+            threads.emplace_back([&] { sum = concurrent.Sum(); });
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(From(sums).All([](int sum) { return sum == 49'995'000; }));
+    }
+
+    SECTION("Statistics")
+    {
+        auto counting = CountingFunction(100);
+        CHECK(counting.GetStatistics() == nullptr);
+
+        auto spStatistics = counting.EnableStatistics();
+        CHECK(counting.GetStatistics() == spStatistics);
+        CHECK(counting.Count() == 100);
+        CHECK_THROWS_AS(counting.EnableStatistics(), std::logic_error);
+
+        CHECK(spStatistics->Values() == 100);
+        CHECK(spStatistics->Handoffs() == 101);
+        CHECK(spStatistics->CallerWaitTime().count() > 0);
+        CHECK(From(spStatistics->LatencyHistogram()).Sum() == spStatistics->Handoffs());
+
+        auto batched = BatchedFunction(100);
+        auto spBatchedStatistics = batched.EnableStatistics();
+        CHECK(batched.Count() == 100);
+        CHECK(spBatchedStatistics->Values() == 100);
+        CHECK(spBatchedStatistics->Handoffs() == 7);
+    }
+
+    SECTION("yield_from")
+    {
+        CHECK(DelegatingFunction({ 1, 2, 3 }).SequenceEqual(std::vector<int>{ -1, 1, 2, 3, 10, 11, 12, -2 }));
+        CHECK(DelegatingFunction({}).SequenceEqual(std::vector<int>{ -1, 10, 11, 12, -2 }));
+        CHECK(DelegatingFunction({ 1, 2, 3 }).ElementAt(2) == 2);
+
+        auto f1 = []
+        {
+            START_YIELDING(int)
+            yield_from(std::vector<int>());
+            END_YIELDING
+        };
+
+        CHECK(!f1().Any());
+    }
+
+    SECTION("yield_break")
+    {
+        CHECK(!BreakingFunction(0).Any());
+        CHECK(BreakingFunction(5).SequenceEqual(Enumerable::Range(0, 5)));
+    }
+
+    SECTION("Cancellation")
+    {
+        auto spOffset = std::make_shared<int>(0);
+        std::weak_ptr<int> wpOffset = spOffset;
+
+        CHECK(InfiniteFunction(spOffset).First() == 0);
+        CHECK(InfiniteFunction(spOffset).Any());
+        CHECK(InfiniteFunction(spOffset).Take(3).SequenceEqual(std::vector<int>{ 0, 1, 2 }));
+        CHECK(InfiniteFunction(spOffset).Skip(10).First() == 10);
+
+        for (auto i : InfiniteFunction(spOffset))
+        {
+            if (i == 5)
+                break;
+        }
+
+        spOffset.reset();
+
+        // The yielding threads release their captures on their own.
+        for (int i = 0; i < 1000 && !wpOffset.expired(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        CHECK(wpOffset.expired());
+
+        // A function that swallows the cancellation is cancelled again by its next yield_return.
+        auto& pool = Yielding::WorkerPool::Instance();
+        auto size = pool.Size();
+        auto restore = Utility::on_exit([&] { pool.SetSize(size); });
+
+        pool.SetSize(0);
+        for (int i = 0; i < 1000 && pool.IdleWorkers() != 0; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        pool.SetSize(1);
+
+        auto spReturned = std::make_shared<std::atomic<int>>(0);
+        for (int i = 0; i < 100; ++i)
+            CHECK(SwallowingFunction(spReturned).First() == 0);
+
+        for (int i = 0; i < 1000 && (*spReturned < 100 || pool.IdleWorkers() == 0); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        CHECK(*spReturned == 100);
+        CHECK(pool.IdleWorkers() == 1);
+    }
 }